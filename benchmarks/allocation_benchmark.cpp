@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+
+#include "trading_strategy_engine/arena.h"
+#include "trading_strategy_engine/engine_types.h"
+
+/**
+ * Cost of the temporaries a strategy builds per tick: a burst of 16 order
+ * intents created and then all dropped, from the global heap (new / delete)
+ * and from an Arena that is reset after the burst.
+ */
+static constexpr std::size_t kBurst = 16;
+
+static void BM_AllocNewDelete(benchmark::State& state)
+{
+    std::array<OrderIntent*, kBurst> live;
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < kBurst; ++i)
+        {
+            live[i] = new OrderIntent{0, static_cast<InstrumentId>(i), Side::Buy, 100.0, 1.0, {}};
+            benchmark::DoNotOptimize(live[i]);
+        }
+        for (OrderIntent* p : live) delete p;
+    }
+    state.SetItemsProcessed(state.iterations() * kBurst);
+}
+
+static void BM_AllocArena(benchmark::State& state)
+{
+    Arena arena(64 * 1024);
+    arena.prefault();
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < kBurst; ++i)
+            benchmark::DoNotOptimize(
+                arena.make<OrderIntent>(OrderIntent{0, static_cast<InstrumentId>(i), Side::Buy, 100.0, 1.0, {}}));
+        arena.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * kBurst);
+}
+
+BENCHMARK(BM_AllocNewDelete);
+BENCHMARK(BM_AllocArena);
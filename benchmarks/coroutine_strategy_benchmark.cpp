@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "trading_strategy_engine/coroutine_strategy.h"
+#include "strategy_fixtures.h"
+
+/**
+ * Cost of delivering a tick to a strategy, per tick, through the batched entry
+ * point a worker uses:
+ *  * VirtualCallback – the per-tick virtual on_market_data() a plain Strategy
+ *    gets by default;
+ *  * CoroutineResume – a CoStrategy looping on co_await next_tick(), i.e. one
+ *    resume and one suspend per tick;
+ *  * CoroutineRestart – a run() that handles one tick and returns, so every
+ *    tick also creates and destroys a frame: from a FrameArena as on a worker,
+ *    or from the heap.
+ */
+class CoEma final : public CoStrategy
+{
+  public:
+    using CoStrategy::CoStrategy;
+    double ema_{100.0};
+
+  private:
+    Task run() override
+    {
+        for (;;)
+        {
+            const TickEvent t = co_await next_tick();
+            ema_ += 0.1 * (t.data.price - ema_);
+        }
+    }
+};
+
+class CoEmaOneShot final : public CoStrategy
+{
+  public:
+    using CoStrategy::CoStrategy;
+    double ema_{100.0};
+
+  private:
+    Task run() override
+    {
+        const TickEvent t = co_await next_tick();
+        ema_ += 0.1 * (t.data.price - ema_);
+    }
+};
+
+template <typename S> static void run_bursts(benchmark::State& state)
+{
+    const auto burst = make_burst();
+    std::unique_ptr<Strategy> owned = std::make_unique<S>(0, "ema");
+    Strategy* s = owned.get();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(s);
+        s->on_market_data(std::span<const MarketDataAction>(burst));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(burst.size()));
+}
+
+static void BM_StrategyVirtualCallback(benchmark::State& state) { run_bursts<VirtualEma>(state); }
+static void BM_StrategyCoroutineResume(benchmark::State& state) { run_bursts<CoEma>(state); }
+
+static void BM_StrategyCoroutineRestartArena(benchmark::State& state)
+{
+    FrameArena arena(64 * 1024);
+    FrameArena::current() = &arena;
+    run_bursts<CoEmaOneShot>(state);
+    FrameArena::current() = nullptr;
+}
+static void BM_StrategyCoroutineRestartHeap(benchmark::State& state) { run_bursts<CoEmaOneShot>(state); }
+
+BENCHMARK(BM_StrategyVirtualCallback);
+BENCHMARK(BM_StrategyCoroutineResume);
+BENCHMARK(BM_StrategyCoroutineRestartArena);
+BENCHMARK(BM_StrategyCoroutineRestartHeap);
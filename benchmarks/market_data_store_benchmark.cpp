@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "trading_strategy_engine/market_data_store.h"
+
+/**
+ * One writer (thread 0, the dispatcher's role) updates quotes while the
+ * remaining threads read them, across a small hot set of instruments.
+ * ->Threads(n) runs n - 1 readers, so the sweep shows how each store scales
+ * as reader fan-out grows.
+ */
+constexpr InstrumentId kHotInstruments = 16;
+
+template <typename Store> static void BM_StoreOneWriterManyReaders(benchmark::State &state)
+{
+    static Store store;
+
+    std::int64_t ops = 0;
+    InstrumentId inst = static_cast<InstrumentId>(state.thread_index()) % kHotInstruments;
+    if (state.thread_index() == 0)
+    {
+        double price = 100.0;
+        for (auto _ : state)
+        {
+            store.update(inst, MarketData{price, 1.0, std::chrono::steady_clock::time_point{}});
+            price += 0.01;
+            inst = (inst + 1) % kHotInstruments;
+            ++ops;
+        }
+        state.counters["writes"] = benchmark::Counter(static_cast<double>(ops), benchmark::Counter::kIsRate);
+    }
+    else
+    {
+        for (auto _ : state)
+        {
+            auto md = store.latest(inst);
+            benchmark::DoNotOptimize(md);
+            inst = (inst + 1) % kHotInstruments;
+            ++ops;
+        }
+        state.counters["reads"] = benchmark::Counter(static_cast<double>(ops), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_StoreOneWriterManyReaders, SharedMutexMarketDataStore)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_StoreOneWriterManyReaders, SeqlockMarketDataStore)->ThreadRange(2, 16)->UseRealTime();
+
+/**
+ * Startup-to-ready of a persistent store: map a snapshot holding
+ * state.range(0) recent quotes, check and re-home them. Each iteration is one
+ * engine restart.
+ */
+static void BM_StoreWarmStart(benchmark::State &state)
+{
+    const std::string path = "/tmp/market_data_store_bench.snap";
+    const auto n = static_cast<InstrumentId>(state.range(0));
+    std::remove(path.c_str());
+    {
+        SymbolTable instruments;
+        for (InstrumentId i = 0; i < n; ++i)
+        {
+            std::string name = "I";
+            name += std::to_string(i);
+            instruments.intern(name);
+        }
+        SeqlockMarketDataStore store(path, instruments);
+        for (InstrumentId i = 0; i < n; ++i)
+            store.update(i, MarketData{100.0 + i, 1.0, std::chrono::steady_clock::now()});
+    }
+    for (auto _ : state)
+    {
+        SymbolTable instruments;
+        SeqlockMarketDataStore store(path, instruments);
+        benchmark::DoNotOptimize(store.latest(0));
+        if (store.recovered() != static_cast<std::size_t>(n))
+            state.SkipWithError("quotes lost across a restart");
+    }
+    std::remove(path.c_str());
+}
+
+BENCHMARK(BM_StoreWarmStart)->Arg(16)->Arg(4096)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "trading_strategy_engine/order_book.h"
+
+/**
+ * Book building on a realistic message mix: level updates clustered within a
+ * few dozen ticks of the touch, about a third of them deletes, plus a top-5
+ * read of one side every 8 messages. OrderBook (flat arrays + bitmaps) against
+ * a node-based book of one std::map per side.
+ */
+struct BookMsg
+{
+    Side   side;
+    int    op; // 0 add, 1 modify, 2 delete
+    double price;
+    double qty;
+};
+
+static const std::vector<BookMsg>& messages()
+{
+    static const std::vector<BookMsg> msgs = [] {
+        std::mt19937 rng(42);
+        std::vector<BookMsg> v(1 << 16);
+        for (BookMsg& m : v)
+        {
+            m.side  = rng() & 1 ? Side::Buy : Side::Sell;
+            m.op    = static_cast<int>(rng() % 3);
+            const int offset = 1 + static_cast<int>(rng() % 32); // ticks from mid
+            m.price = (10'000 + (m.side == Side::Buy ? -offset : offset)) * 0.01;
+            m.qty   = 1 + rng() % 100;
+        }
+        return v;
+    }();
+    return msgs;
+}
+
+class MapBook
+{
+  public:
+    void apply(const BookMsg& m)
+    {
+        if (m.side == Side::Buy) apply(bids_, m);
+        else apply(asks_, m);
+    }
+    std::size_t top(Side s, std::span<BookLevel> out) const
+    {
+        std::size_t n = 0;
+        if (s == Side::Buy)
+            for (auto it = bids_.begin(); it != bids_.end() && n < out.size(); ++it) out[n++] = {it->first, it->second};
+        else
+            for (auto it = asks_.begin(); it != asks_.end() && n < out.size(); ++it) out[n++] = {it->first, it->second};
+        return n;
+    }
+
+  private:
+    template <typename Map> static void apply(Map& side, const BookMsg& m)
+    {
+        if (m.op == 0) side[m.price] += m.qty;
+        else if (m.op == 1) side[m.price] = m.qty;
+        else side.erase(m.price);
+    }
+
+    std::map<double, double, std::greater<>> bids_;
+    std::map<double, double>                 asks_;
+};
+
+static void BM_OrderBookFlat(benchmark::State& state)
+{
+    const auto& msgs = messages();
+    OrderBook   book(0.01, 100.0);
+    std::array<BookLevel, 5> top;
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        const BookMsg& m = msgs[i++ & (msgs.size() - 1)];
+        if (m.op == 0) book.add(m.side, m.price, m.qty);
+        else if (m.op == 1) book.modify(m.side, m.price, m.qty);
+        else book.remove(m.side, m.price);
+        if ((i & 7) == 0) benchmark::DoNotOptimize(book.top(m.side, top));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_OrderBookStdMap(benchmark::State& state)
+{
+    const auto& msgs = messages();
+    MapBook     book;
+    std::array<BookLevel, 5> top;
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        const BookMsg& m = msgs[i++ & (msgs.size() - 1)];
+        book.apply(m);
+        if ((i & 7) == 0) benchmark::DoNotOptimize(book.top(m.side, top));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_OrderBookFlat);
+BENCHMARK(BM_OrderBookStdMap);
@@ -0,0 +1,373 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "spsc_queue.h"
+#include "trading_strategy_engine/platform.h"
+#include "trading_strategy_engine/shm_ring.h"
+#include "trading_strategy_engine/spsc_ring_buffer.h"
+#include "trading_strategy_engine/thread_placement.h"
+
+/**
+ * Queues and hand-off paths, one producer and one consumer:
+ *  * PushPop    – push then pop one element on a single thread: the
+ *                 bookkeeping cost with no other core involved;
+ *  * Throughput – a consumer thread drains while the producer pushes bursts
+ *                 of kBurst, spinning (then yielding) on full / empty;
+ *  * PingPong   – an echo thread sends every element straight back on a
+ *                 second queue; time per iteration is one round trip.
+ * Payloads of 8, 64 and 256 bytes show the copy cost next to the
+ * synchronisation cost.
+ *
+ * Queues: SpscRingBuffer (the engine's ring), SPSC_Queue (the standalone
+ * queue in multithreading/spsc_queue.h), ShmRing (the shared-memory ring,
+ * both handles in this process) and a std::mutex + std::deque baseline, all
+ * with the same capacity. ShmPingPongProcess runs the echo side in a forked
+ * child attached to the same segments: the real cross-process round trip.
+ *
+ * Pin the two threads with QUEUE_BENCH_CPUS=<producer>,<consumer>; both run
+ * unpinned when it is unset. Same core, SMT siblings and separate physical
+ * cores give very different numbers, so always state which was used.
+ */
+namespace
+{
+constexpr std::size_t kCapacity = 1 << 12;
+constexpr std::size_t kBurst    = 256;
+
+template <std::size_t Bytes> struct Payload
+{
+    std::array<std::byte, Bytes> bytes{};
+};
+
+// Uniform try_push / try_pop over the queues under test.
+template <typename T> class Ring
+{
+  public:
+    using value_type = T;
+    bool try_push(const T& v) noexcept { return q_.push(v); }
+    bool try_pop(T& v) noexcept { return q_.pop(v); }
+
+  private:
+    SpscRingBuffer<T, kCapacity> q_;
+};
+
+template <typename T> class Spsc
+{
+  public:
+    using value_type = T;
+    bool try_push(const T& v) noexcept { return q_.push(v); }
+    bool try_pop(T& v) noexcept { return q_.pop(v); }
+
+  private:
+    SPSC_Queue<T, static_cast<int>(kCapacity)> q_;
+};
+
+std::string unique_shm_name()
+{
+    static int n = 0;
+    return "/queue_bench." + std::to_string(::getpid()) + "." + std::to_string(n++);
+}
+
+// Producer and consumer handle on one segment. The name is unlinked at once;
+// the mappings stay valid.
+template <typename T> class Shm
+{
+  public:
+    using value_type = T;
+    using Ring       = ShmRing<T, kCapacity>;
+
+    Shm(): name_(unique_shm_name()), producer_(name_, Ring::Role::Producer), consumer_(name_, Ring::Role::Consumer)
+    {
+        Ring::unlink(name_);
+    }
+    bool try_push(const T& v) noexcept { return producer_.push(v); }
+    bool try_pop(T& v) noexcept { return consumer_.pop(v); }
+
+  private:
+    std::string name_;
+    Ring        producer_;
+    Ring        consumer_;
+};
+
+template <typename T> class MutexDeque
+{
+  public:
+    using value_type = T;
+    bool try_push(const T& v)
+    {
+        std::lock_guard lock(m_);
+        if (q_.size() == kCapacity) return false;
+        q_.push_back(v);
+        return true;
+    }
+    bool try_pop(T& v)
+    {
+        std::lock_guard lock(m_);
+        if (q_.empty()) return false;
+        v = q_.front();
+        q_.pop_front();
+        return true;
+    }
+
+  private:
+    std::mutex    m_;
+    std::deque<T> q_;
+};
+
+// Spin briefly, then give the core away: the two threads may share one.
+void backoff(std::uint32_t& spins)
+{
+    if (++spins < 64)
+        cpu_relax();
+    else
+        std::this_thread::yield();
+}
+
+struct BenchCpus
+{
+    int producer{-1};
+    int consumer{-1};
+};
+
+BenchCpus bench_cpus()
+{
+    BenchCpus cpus;
+    if (const char* s = std::getenv("QUEUE_BENCH_CPUS")) std::sscanf(s, "%d,%d", &cpus.producer, &cpus.consumer);
+    return cpus;
+}
+
+// Pins the calling thread for the scope and restores its old affinity after,
+// so the main thread does not stay pinned for the benchmarks that follow.
+class PinScope
+{
+  public:
+    explicit PinScope(int cpu)
+    {
+        saved_ = ::pthread_getaffinity_np(::pthread_self(), sizeof(old_), &old_) == 0 && cpu >= 0;
+        pin_current_thread(cpu);
+    }
+    ~PinScope()
+    {
+        if (saved_) ::pthread_setaffinity_np(::pthread_self(), sizeof(old_), &old_);
+    }
+    PinScope(const PinScope&)            = delete;
+    PinScope& operator=(const PinScope&) = delete;
+
+  private:
+    cpu_set_t old_{};
+    bool      saved_{false};
+};
+
+template <typename Q> void push_blocking(Q& q, const typename Q::value_type& v)
+{
+    for (std::uint32_t spins = 0; !q.try_push(v);) backoff(spins);
+}
+template <typename Q> void pop_blocking(Q& q, typename Q::value_type& v)
+{
+    for (std::uint32_t spins = 0; !q.try_pop(v);) backoff(spins);
+}
+
+template <typename R, typename T> void push_blocking_shm(R& ring, const T& v)
+{
+    for (std::uint32_t spins = 0; !ring.push(v);) backoff(spins);
+}
+
+using P8   = Payload<8>;
+using P64  = Payload<64>;
+using P256 = Payload<256>;
+} // namespace
+
+template <typename Q> static void BM_QueuePushPop(benchmark::State& state)
+{
+    auto                   q = std::make_unique<Q>();
+    typename Q::value_type v{};
+    for (auto _ : state)
+    {
+        q->try_push(v);
+        q->try_pop(v);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Q> static void BM_QueueThroughput(benchmark::State& state)
+{
+    using T                = typename Q::value_type;
+    auto              q    = std::make_unique<Q>();
+    const BenchCpus   cpus = bench_cpus();
+    std::atomic<bool> stop{false};
+    std::thread       consumer([&] {
+        pin_current_thread(cpus.consumer);
+        T             v{};
+        std::uint32_t spins = 0;
+        while (true)
+        {
+            if (q->try_pop(v))
+            {
+                benchmark::DoNotOptimize(v);
+                spins = 0;
+            }
+            else if (stop.load(std::memory_order_acquire))
+            {
+                // Everything pushed before stop is visible now.
+                while (q->try_pop(v)) benchmark::DoNotOptimize(v);
+                break;
+            }
+            else
+                backoff(spins);
+        }
+    });
+
+    {
+        const PinScope pin(cpus.producer);
+        const T        v{};
+        for (auto _ : state)
+            for (std::size_t i = 0; i < kBurst; ++i) push_blocking(*q, v);
+    }
+    stop.store(true, std::memory_order_release);
+    consumer.join();
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kBurst));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(kBurst * sizeof(T)));
+}
+
+template <typename Q> static void BM_QueuePingPong(benchmark::State& state)
+{
+    using T                = typename Q::value_type;
+    auto              ping = std::make_unique<Q>();
+    auto              pong = std::make_unique<Q>();
+    const BenchCpus   cpus = bench_cpus();
+    std::atomic<bool> stop{false};
+    std::thread       echo([&] {
+        pin_current_thread(cpus.consumer);
+        T             v{};
+        std::uint32_t spins = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            if (ping->try_pop(v))
+            {
+                push_blocking(*pong, v);
+                spins = 0;
+            }
+            else
+                backoff(spins);
+        }
+    });
+
+    {
+        const PinScope pin(cpus.producer);
+        T              v{};
+        for (auto _ : state)
+        {
+            push_blocking(*ping, v);
+            pop_blocking(*pong, v);
+        }
+    }
+    stop.store(true, std::memory_order_relaxed);
+    echo.join();
+}
+
+template <typename T> static void BM_ShmPingPongProcess(benchmark::State& state)
+{
+    using Ring                  = ShmRing<T, kCapacity>;
+    const std::string ping_name = unique_shm_name();
+    const std::string pong_name = unique_shm_name();
+    const BenchCpus   cpus      = bench_cpus();
+    Ring              ping(ping_name, Ring::Role::Producer);
+    Ring              pong(pong_name, Ring::Role::Consumer);
+
+    const pid_t child = ::fork();
+    if (child == 0)
+    {
+        pin_current_thread(cpus.consumer);
+        Ring          in(ping_name, Ring::Role::Consumer);
+        Ring          out(pong_name, Ring::Role::Producer);
+        T             v{};
+        std::uint32_t spins = 0;
+        while (true)
+        {
+            if (in.pop(v))
+            {
+                push_blocking_shm(out, v);
+                spins = 0;
+            }
+            else if (spins > 1024 && !in.peer_alive())
+                ::_exit(0);
+            else
+                backoff(spins);
+        }
+    }
+    if (child < 0)
+    {
+        state.SkipWithError("fork failed");
+        return;
+    }
+    while (!ping.peer_alive() || !pong.peer_alive()) std::this_thread::yield();
+
+    {
+        const PinScope pin(cpus.producer);
+        T              v{};
+        for (auto _ : state)
+        {
+            for (std::uint32_t spins = 0; !ping.push(v);) backoff(spins);
+            for (std::uint32_t spins = 0; !pong.pop(v);) backoff(spins);
+        }
+    }
+    ::kill(child, SIGKILL);
+    ::waitpid(child, nullptr, 0);
+    Ring::unlink(ping_name);
+    Ring::unlink(pong_name);
+}
+
+BENCHMARK_TEMPLATE(BM_QueuePushPop, Ring<P8>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, Ring<P64>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, Ring<P256>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, Spsc<P8>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, Spsc<P64>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, Spsc<P256>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, Shm<P8>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, Shm<P64>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, Shm<P256>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, MutexDeque<P8>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, MutexDeque<P64>);
+BENCHMARK_TEMPLATE(BM_QueuePushPop, MutexDeque<P256>);
+
+BENCHMARK_TEMPLATE(BM_QueueThroughput, Ring<P8>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, Ring<P64>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, Ring<P256>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, Spsc<P8>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, Spsc<P64>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, Spsc<P256>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, Shm<P8>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, Shm<P64>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, Shm<P256>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, MutexDeque<P8>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, MutexDeque<P64>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueThroughput, MutexDeque<P256>)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_QueuePingPong, Ring<P8>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePingPong, Ring<P256>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePingPong, Spsc<P8>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePingPong, Spsc<P256>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePingPong, Shm<P8>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePingPong, Shm<P256>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePingPong, MutexDeque<P8>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueuePingPong, MutexDeque<P256>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ShmPingPongProcess, P8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ShmPingPongProcess, P256)->UseRealTime();
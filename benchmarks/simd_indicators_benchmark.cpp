@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "trading_strategy_engine/simd_indicators.h"
+
+/**
+ * One universe snapshot (EMA, variance, VWAP, z-score for every instrument)
+ * per iteration, per kernel. Levels the CPU lacks are skipped.
+ */
+template <SimdLevel Level> static void BM_IndicatorSnapshot(benchmark::State& state)
+{
+    if (detect_simd_level() < Level)
+    {
+        state.SkipWithError("CPU lacks this SIMD level");
+        return;
+    }
+    const auto          n = static_cast<std::size_t>(state.range(0));
+    std::mt19937        rng(7);
+    std::vector<double> price(n), volume(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        price[i]  = 100.0 + rng() % 1000 / 10.0;
+        volume[i] = rng() % 100;
+    }
+    IndicatorEngine engine(n, {}, Level);
+    engine.update(price, volume);
+    for (auto _ : state)
+    {
+        price[rng() % n] += 0.01; // keep the inputs from being loop invariant
+        engine.update(price, volume);
+        benchmark::DoNotOptimize(engine.zscore().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+BENCHMARK_TEMPLATE(BM_IndicatorSnapshot, SimdLevel::Scalar)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_IndicatorSnapshot, SimdLevel::Avx2)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_IndicatorSnapshot, SimdLevel::Avx512)->Arg(4096);
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "trading_strategy_engine/strategy.h"
+#include "strategy_fixtures.h"
+
+/**
+ * Cost of handing a drained burst to a cheap strategy (an EMA of the price):
+ *  * PerTick – one virtual on_market_data(const MarketData&) per tick, the
+ *    worker's behaviour before batching;
+ *  * Batched – one virtual call per burst, then the strategy's own loop.
+ * VirtualEma only overrides the per-tick function, so its batch falls back to
+ * a virtual call per tick; StaticEma derives from StaticStrategy and its
+ * on_batch keeps the EMA in a register for the whole burst.
+ */
+class StaticEma final : public StaticStrategy<StaticEma>
+{
+  public:
+    using StaticStrategy::StaticStrategy;
+    void on_tick(const MarketData& md) { ema_ += 0.1 * (md.price - ema_); }
+    void on_batch(std::span<const MarketDataAction> batch)
+    {
+        double ema = ema_;
+        for (const MarketDataAction& a : batch) ema += 0.1 * (a.data.price - ema);
+        ema_ = ema;
+    }
+    double ema_{100.0};
+};
+
+template <typename S> static void BM_StrategyPerTick(benchmark::State& state)
+{
+    const auto burst = make_burst();
+    std::unique_ptr<Strategy> owned = std::make_unique<S>(0, "ema");
+    Strategy* s = owned.get();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(s); // keep the call indirect
+        for (const MarketDataAction& a : burst) s->on_market_data(a.data);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(burst.size()));
+}
+
+template <typename S> static void BM_StrategyBatched(benchmark::State& state)
+{
+    const auto burst = make_burst();
+    std::unique_ptr<Strategy> owned = std::make_unique<S>(0, "ema");
+    Strategy* s = owned.get();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(s);
+        s->on_market_data(std::span<const MarketDataAction>(burst));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(burst.size()));
+}
+
+BENCHMARK_TEMPLATE(BM_StrategyPerTick, VirtualEma);
+BENCHMARK_TEMPLATE(BM_StrategyPerTick, StaticEma);
+BENCHMARK_TEMPLATE(BM_StrategyBatched, VirtualEma);
+BENCHMARK_TEMPLATE(BM_StrategyBatched, StaticEma);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "trading_strategy_engine/strategy.h"
+
+/**
+ * Shared by the strategy benchmarks: a cheap strategy (an EMA of the price)
+ * that only overrides the per-tick virtual, and one drained burst of ticks.
+ */
+class VirtualEma final : public Strategy
+{
+  public:
+    using Strategy::Strategy;
+    using Strategy::on_market_data;
+    void on_market_data(const MarketData& md) override { ema_ += 0.1 * (md.price - ema_); }
+    double ema_{100.0};
+};
+
+inline std::array<MarketDataAction, kDrainBatch> make_burst()
+{
+    std::array<MarketDataAction, kDrainBatch> burst{};
+    for (std::size_t i = 0; i < burst.size(); ++i)
+        burst[i].data = MarketData{100.0 + static_cast<double>(i % 7), 1.0, {}};
+    return burst;
+}
@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+
+#include "trading_strategy_engine/strategy_engine.h"
+#include "trading_strategy_engine/work_stealing.h"
+
+/**
+ * Skewed strategy costs: 16 instruments with one strategy each, 4 workers.
+ * Instruments 0 and 4 cost 40x the others per tick, and the static pool's
+ * round-robin assignment puts both on worker 0 - the "one expensive strategy
+ * backs up its worker" case. Each iteration feeds a round of ticks across all
+ * instruments and waits until every strategy has seen them.
+ *
+ * Reported per run: ticks/s, and p50 / p99 of tick-to-completion latency (tick
+ * stamp to the end of the strategy's work on it).
+ *
+ * Static pool: one strategy per worker as assigned. WorkStealing: one lane per
+ * instrument, idle workers steal whole lanes.
+ */
+namespace
+{
+constexpr std::size_t kInstruments = 16;
+constexpr std::size_t kWorkers     = 4;
+constexpr std::size_t kRound       = 64; // ticks per instrument per iteration
+
+std::uint32_t cost_of(InstrumentId inst) { return inst % 4 == 0 && inst < 8 ? 4000 : 100; }
+
+class SpinStrategy final : public StaticStrategy<SpinStrategy>
+{
+  public:
+    SpinStrategy(StrategyId id, std::uint32_t cost, std::atomic<std::uint64_t>& done)
+        : StaticStrategy(id, "spin"), cost_(cost), done_(done)
+    {}
+
+    void on_tick(const MarketData& md)
+    {
+        double x = md.price;
+        for (std::uint32_t i = 0; i < cost_; ++i) x = x * 1.0000001 + 1e-9;
+        benchmark::DoNotOptimize(x);
+        latency_.record(std::chrono::steady_clock::now() - md.ts);
+    }
+    void on_batch(std::span<const MarketDataAction> batch)
+    {
+        for (const MarketDataAction& a : batch) on_tick(a.data);
+        done_.fetch_add(batch.size(), std::memory_order_release);
+    }
+
+    const LatencyHistogram& latency() const noexcept { return latency_; }
+
+  private:
+    const std::uint32_t         cost_;
+    std::atomic<std::uint64_t>& done_;
+    LatencyHistogram            latency_;
+};
+
+MarketDataAction tick(InstrumentId inst, StrategyId sid)
+{
+    return {inst, sid, ActionKind::Tick, {100.0, 1.0, std::chrono::steady_clock::now()}, {}};
+}
+
+void report(benchmark::State& state, const std::array<SpinStrategy*, kInstruments>& strategies)
+{
+    LatencyHistogram::Snapshot s;
+    for (const SpinStrategy* st : strategies) s += st->latency().snapshot();
+    const LatencyHistogram::Report r = s.report();
+    state.counters["p50_us"] = static_cast<double>(r.p50) / 1e3;
+    state.counters["p99_us"] = static_cast<double>(r.p99) / 1e3;
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kInstruments * kRound));
+}
+
+void wait_for(const std::atomic<std::uint64_t>& done, std::uint64_t target)
+{
+    while (done.load(std::memory_order_acquire) < target) std::this_thread::yield();
+}
+} // namespace
+
+static void BM_SkewStaticPool(benchmark::State& state)
+{
+    ThreadPoolOfStrategies pool(kWorkers, {.wait = {WaitPolicy::SpinYield}});
+    std::atomic<std::uint64_t> done{0};
+    std::array<SpinStrategy*, kInstruments> strategies{};
+    for (InstrumentId i = 0; i < kInstruments; ++i)
+    {
+        auto s        = std::make_unique<SpinStrategy>(i, cost_of(i), done);
+        strategies[i] = s.get();
+        pool.add_strategy(std::move(s), i % kWorkers);
+    }
+    std::uint64_t sent = 0;
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < kRound; ++k)
+            for (InstrumentId i = 0; i < kInstruments; ++i)
+            {
+                while (!pool.dispatch(tick(i, i))) std::this_thread::yield();
+                ++sent;
+            }
+        wait_for(done, sent);
+    }
+    report(state, strategies);
+}
+
+static void BM_SkewWorkStealing(benchmark::State& state)
+{
+    WorkStealingExecutor ex(kWorkers, {.wait = {WaitPolicy::SpinYield}});
+    std::atomic<std::uint64_t> done{0};
+    std::array<SpinStrategy*, kInstruments> strategies{};
+    for (InstrumentId i = 0; i < kInstruments; ++i)
+    {
+        auto s        = std::make_unique<SpinStrategy>(i, cost_of(i), done);
+        strategies[i] = s.get();
+        ex.add_strategy(std::move(s), i);
+    }
+    std::uint64_t sent = 0;
+    for (auto _ : state)
+    {
+        for (std::size_t k = 0; k < kRound; ++k)
+            for (InstrumentId i = 0; i < kInstruments; ++i)
+            {
+                while (!ex.submit(tick(i, i))) std::this_thread::yield();
+                ++sent;
+            }
+        wait_for(done, sent);
+    }
+    report(state, strategies);
+}
+
+BENCHMARK(BM_SkewStaticPool)->UseRealTime();
+BENCHMARK(BM_SkewWorkStealing)->UseRealTime();
@@ -1,5 +1,13 @@
+#pragma once
+
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <optional>
+#include <type_traits>
+#include <utility>
 
 constexpr bool is_power_of_2(const int n)
 {
@@ -11,45 +19,140 @@ constexpr bool is_power_of_2(const int n)
     return (n & (n - 1)) == 0;
 }
 
-template <typename T, int size> class SPSC_Queue
+/**
+ * Bounded single-producer / single-consumer queue.
+ *
+ * head_ and tail_ are free-running counters; the slot is counter & (Size - 1),
+ * so indices wrap without a branch and all Size slots are usable. One thread
+ * may call the producer side (push / emplace), one other thread the consumer
+ * side (pop / front).
+ *
+ * Each side owns a cache line holding its index and a private copy of the
+ * other side's index, and only re-reads the shared index when its copy says
+ * full / empty. In steady state a push or a pop therefore touches no line the
+ * other core writes. The slots start on their own line.
+ *
+ * Slots are raw storage: elements are constructed in place and destroyed when
+ * popped, so T needs no default constructor.
+ */
+template <typename T, int Size> class SPSC_Queue
 {
-    static_assert(is_power_of_2(size), "SPSC_Queue can only be declared with 2^n size.");
+    static_assert(is_power_of_2(Size), "SPSC_Queue can only be declared with 2^n size.");
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>,
+                  "SPSC_Queue elements must be nothrow movable and destructible.");
 
   public:
     SPSC_Queue() = default;
+    SPSC_Queue(const SPSC_Queue&)            = delete;
+    SPSC_Queue& operator=(const SPSC_Queue&) = delete;
 
-    bool push(const T& item)
+    ~SPSC_Queue()
     {
-        if (head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_relaxed) + 1)
+        if constexpr (!std::is_trivially_destructible_v<T>)
         {
-            ring_buffer_[head_.fetch_add(1, std::memory_order_release)] = item;
-            return true;
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            for (std::size_t i = tail_.load(std::memory_order_relaxed); i != head; ++i)
+                std::destroy_at(slot(i));
         }
-        // drop
-        return false;
     }
 
-    T pop()
+    /**
+     * Producer side. All return false, leaving the queue unchanged, when it is
+     * full.
+     */
+    template <typename... Args> bool emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
     {
-        if (head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_relaxed))
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == kCapacity)
         {
-            return ring_buffer_[tail_.fetch_add(1, std::memory_order_release)];
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ == kCapacity)
+                return false;
         }
-        return std::nullptr_t;
+        std::construct_at(slot(head), std::forward<Args>(args)...);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& item) noexcept(std::is_nothrow_copy_constructible_v<T>) { return emplace(item); }
+    bool push(T&& item) noexcept { return emplace(std::move(item)); }
+
+    /**
+     * Consumer side.
+     */
+    bool pop(T& out) noexcept(std::is_nothrow_move_assignable_v<T>)
+    {
+        T* p = front();
+        if (!p)
+            return false;
+        out = std::move(*p);
+        release(p);
+        return true;
     }
 
-    T &top() const
+    std::optional<T> pop() noexcept
     {
-        if (head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_relaxed))
+        T* p = front();
+        if (!p)
+            return std::nullopt;
+        std::optional<T> out(std::move(*p));
+        release(p);
+        return out;
+    }
+
+    // The oldest element, left in the queue; nullptr when empty.
+    T* front() noexcept
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_)
         {
-            return ring_buffer_[tail_.load(std::memory_order_acquire)];
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_)
+                return nullptr;
         }
-        return std::nullptr_t;
+        return slot(tail);
     }
 
+    /**
+     * Either side. Exact while the other side is idle; otherwise a snapshot
+     * that may be stale but is never negative and never above capacity.
+     */
+    std::size_t size() const noexcept
+    {
+        // tail first: head only grows, so the later head read is >= tail.
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        return std::min(head - tail, kCapacity);
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    static constexpr std::size_t capacity() noexcept { return kCapacity; }
+
   private:
-    T                ring_buffer_[size];
-    std::atomic<int> head_  = 0;
-    std::atomic<int> tail_  = 0;
-    std::atomic<int> length = 0;
-};
\ No newline at end of file
+    static constexpr std::size_t kCapacity  = static_cast<std::size_t>(Size);
+    static constexpr std::size_t kMask      = kCapacity - 1;
+    static constexpr std::size_t kCacheLine = 64;
+
+    struct Slot
+    {
+        alignas(T) std::byte bytes[sizeof(T)];
+    };
+
+    T* slot(std::size_t i) noexcept { return std::launder(reinterpret_cast<T*>(ring_buffer_[i & kMask].bytes)); }
+
+    // Destroys the front element and hands its slot back to the producer.
+    void release(T* p) noexcept
+    {
+        std::destroy_at(p);
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // producer line
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+    std::size_t                                  tail_cache_{0};
+    // consumer line
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+    std::size_t                                  head_cache_{0};
+
+    alignas(kCacheLine) Slot ring_buffer_[kCapacity];
+};
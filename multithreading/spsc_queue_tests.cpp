@@ -0,0 +1,123 @@
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+/**
+ * Standalone checks for SPSC_Queue; exits non-zero on the first failure.
+ * Worth running under -fsanitize=thread as well:
+ *   g++ -std=c++2b -O1 -g -fsanitize=thread spsc_queue_tests.cpp -o spsc_queue_tests
+ */
+
+#define CHECK(cond)                                                                                                    \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #cond ") failed\n";                                 \
+            std::exit(1);                                                                                              \
+        }                                                                                                              \
+    } while (0)
+
+// Counts live instances; has no default constructor.
+struct Tracked
+{
+    static inline int live = 0;
+
+    explicit Tracked(int v): value(v) { ++live; }
+    Tracked(Tracked&& o) noexcept: value(o.value) { ++live; }
+    Tracked& operator=(Tracked&& o) noexcept
+    {
+        value = o.value;
+        return *this;
+    }
+    ~Tracked() { --live; }
+
+    int value;
+};
+
+void FillDrainAndWrapAround()
+{
+    SPSC_Queue<int, 8> q;
+    CHECK(q.empty() && q.capacity() == 8);
+    for (int round = 0; round < 100; ++round)
+    {
+        for (int i = 0; i < 8; ++i) CHECK(q.push(round * 8 + i));
+        CHECK(!q.push(-1));
+        CHECK(q.size() == 8);
+        CHECK(*q.front() == round * 8);
+        for (int i = 0; i < 8; ++i)
+        {
+            int v = -1;
+            CHECK(q.pop(v) && v == round * 8 + i);
+        }
+        CHECK(!q.pop().has_value());
+        CHECK(q.front() == nullptr && q.empty());
+    }
+}
+
+void MoveOnlyAndEmplace()
+{
+    SPSC_Queue<std::unique_ptr<int>, 4> q;
+    CHECK(q.push(std::make_unique<int>(1)));
+    CHECK(q.emplace(new int(2)));
+    std::optional<std::unique_ptr<int>> a = q.pop();
+    CHECK(a && **a == 1);
+    std::unique_ptr<int> b;
+    CHECK(q.pop(b) && *b == 2);
+}
+
+void ElementsAreDestroyed()
+{
+    {
+        SPSC_Queue<Tracked, 16> q;
+        for (int i = 0; i < 10; ++i) CHECK(q.emplace(i));
+        CHECK(Tracked::live == 10);
+        CHECK(q.pop()->value == 0);
+        CHECK(Tracked::live == 9);
+    }
+    CHECK(Tracked::live == 0); // the destructor drops what is left
+}
+
+// One producer, one consumer, one observer reading size(): every value
+// arrives exactly once and in order, and size() stays within [0, capacity].
+void TwoThreadStress()
+{
+    constexpr std::uint64_t kCount = 5'000'000;
+    auto                    q      = std::make_unique<SPSC_Queue<std::uint64_t, 1024>>();
+    std::atomic<bool>       done{false};
+
+    std::thread producer([&] {
+        for (std::uint64_t i = 0; i < kCount; ++i)
+            while (!q->push(i)) std::this_thread::yield();
+    });
+    std::thread observer([&] {
+        while (!done.load(std::memory_order_relaxed)) CHECK(q->size() <= q->capacity());
+    });
+
+    std::uint64_t expected = 0;
+    while (expected < kCount)
+    {
+        if (std::optional<std::uint64_t> v = q->pop())
+            CHECK(*v == expected++);
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+    done.store(true, std::memory_order_relaxed);
+    observer.join();
+    CHECK(q->empty());
+}
+
+int main()
+{
+    FillDrainAndWrapAround();
+    MoveOnlyAndEmplace();
+    ElementsAreDestroyed();
+    TwoThreadStress();
+    std::cout << "spsc_queue_tests: all passed\n";
+}
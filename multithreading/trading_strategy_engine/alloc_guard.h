@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include <unistd.h>
+
+// ---------- No-allocation scopes for engine threads -------------------------
+
+/*
+ * A global operator new hook (same idea as scribling/main.cpp) that reports
+ * to the calling thread's current NoAllocScope, if any. Engine threads open a
+ * scope once warm-up is over, so any allocation on the hot path afterwards is
+ * counted against that thread or, with AllocPolicy::Abort, stops the process
+ * at the offending call (run it under a debugger to get the stack).
+ *
+ * The hook itself is installed by defining ENGINE_INSTALL_ALLOC_HOOK before
+ * including this header in exactly one translation unit; without it nothing
+ * is counted. The check stays on in release builds: a scope is two
+ * thread-local stores, and the hook one thread-local load per allocation.
+ */
+enum class AllocPolicy : std::uint8_t
+{
+    Count,
+    Abort,
+};
+
+// Allocations one thread made inside its no-allocation scopes. Written by that
+// thread only; any thread may read it.
+class AllocCounter
+{
+  public:
+    void hit(std::size_t bytes) noexcept
+    {
+        count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        bytes_.store(bytes_.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+    std::uint64_t bytes() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+};
+
+struct AllocGuard
+{
+    static inline std::atomic<AllocPolicy>     policy{AllocPolicy::Count};
+    static inline thread_local AllocCounter*   current = nullptr;
+
+    // Called by the hook for every allocation. Must not allocate.
+    static void on_alloc(std::size_t bytes) noexcept
+    {
+        AllocCounter* c = current;
+        if (!c) return;
+        c->hit(bytes);
+        if (policy.load(std::memory_order_relaxed) == AllocPolicy::Abort)
+        {
+            current = nullptr;
+            static constexpr char kMsg[] = "allocation inside NoAllocScope\n";
+            [[maybe_unused]] const auto r = ::write(STDERR_FILENO, kMsg, sizeof(kMsg) - 1);
+            std::abort();
+        }
+    }
+};
+
+// While alive, allocations on this thread are reported to counter. Nests;
+// AllowAllocScope lifts it for a deliberate cold-path detour.
+class NoAllocScope
+{
+  public:
+    explicit NoAllocScope(AllocCounter& counter) noexcept: prev_(AllocGuard::current)
+    {
+        AllocGuard::current = &counter;
+    }
+    ~NoAllocScope() { AllocGuard::current = prev_; }
+
+    NoAllocScope(const NoAllocScope&)            = delete;
+    NoAllocScope& operator=(const NoAllocScope&) = delete;
+
+  private:
+    AllocCounter* prev_;
+};
+
+class AllowAllocScope
+{
+  public:
+    AllowAllocScope() noexcept: prev_(AllocGuard::current) { AllocGuard::current = nullptr; }
+    ~AllowAllocScope() { AllocGuard::current = prev_; }
+
+    AllowAllocScope(const AllowAllocScope&)            = delete;
+    AllowAllocScope& operator=(const AllowAllocScope&) = delete;
+
+  private:
+    AllocCounter* prev_;
+};
+
+#if defined(ENGINE_INSTALL_ALLOC_HOOK)
+// Replacements for the global allocation functions; array and nothrow forms
+// forward to these in libstdc++. They are a matching pair over malloc / free,
+// kept out of line: inlined into this TU, GCC would see free() applied to the
+// result of operator new and warn (-Wmismatched-new-delete).
+[[gnu::noinline]] void* operator new(std::size_t n)
+{
+    AllocGuard::on_alloc(n);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void* operator new(std::size_t n, std::align_val_t al)
+{
+    AllocGuard::on_alloc(n);
+    const auto a = static_cast<std::size_t>(al);
+    if (void* p = std::aligned_alloc(a, (n + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "platform.h"
+
+// ---------- Arenas ----------------------------------------------------------
+
+/*
+ * Bump allocator over one preallocated block, for one thread. Allocation is a
+ * pointer increment; nothing is freed individually, reset() drops everything
+ * at once. Meant for per-burst scratch: a worker resets its arena after each
+ * burst, so strategies can build temporaries on the hot path for free.
+ * Destructors are not run; keep non-trivially-destructible types out or
+ * destroy them yourself.
+ */
+class Arena
+{
+  public:
+    explicit Arena(std::size_t bytes)
+        : base_(static_cast<std::byte*>(::operator new(bytes, std::align_val_t{kCacheLine}))), capacity_(bytes)
+    {}
+    ~Arena() { ::operator delete(base_, std::align_val_t{kCacheLine}); }
+
+    Arena(const Arena&)            = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // The arena of the calling engine thread; nullptr elsewhere.
+    static Arena*& current() noexcept
+    {
+        thread_local Arena* arena = nullptr;
+        return arena;
+    }
+
+    // nullptr when the block is exhausted.
+    void* allocate(std::size_t n, std::size_t align = alignof(std::max_align_t)) noexcept
+    {
+        const std::size_t at = (used_ + align - 1) & ~(align - 1);
+        if (at + n > capacity_) return nullptr;
+        used_       = at + n;
+        high_water_ = std::max(high_water_, used_);
+        return base_ + at;
+    }
+
+    template <typename T, typename... Args> T* make(Args&&... args)
+    {
+        void* p = allocate(sizeof(T), alignof(T));
+        return p ? std::construct_at(static_cast<T*>(p), std::forward<Args>(args)...) : nullptr;
+    }
+
+    void reset() noexcept { used_ = 0; }
+
+    // Touches every page from the calling thread (first-touch NUMA placement).
+    void prefault() noexcept { std::fill_n(base_, capacity_, std::byte{0}); }
+
+    std::size_t used() const noexcept { return used_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::size_t high_water() const noexcept { return high_water_; }
+
+  private:
+    std::byte*  base_;
+    std::size_t capacity_;
+    std::size_t used_{0};
+    std::size_t high_water_{0};
+};
+
+/*
+ * Recycling arena for coroutine frames, for one thread. Frames are rounded up
+ * to 64-byte size classes and carved from one preallocated block; a freed
+ * frame goes onto its class's free list and the next frame of that class
+ * reuses it. A strategy coroutine that restarts every cycle therefore reuses
+ * the same block after the first cycle. allocate() returns nullptr when the
+ * request is larger than kMaxFrame or the block is used up; callers fall back
+ * to the heap.
+ */
+class FrameArena
+{
+  public:
+    static constexpr std::size_t kGranule  = 64;
+    static constexpr std::size_t kMaxFrame = 4096;
+
+    explicit FrameArena(std::size_t bytes)
+        : base_(static_cast<std::byte*>(::operator new(bytes, std::align_val_t{kCacheLine}))), capacity_(bytes)
+    {}
+    ~FrameArena() { ::operator delete(base_, std::align_val_t{kCacheLine}); }
+
+    FrameArena(const FrameArena&)            = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // The frame arena of the calling engine thread; nullptr elsewhere.
+    static FrameArena*& current() noexcept
+    {
+        thread_local FrameArena* arena = nullptr;
+        return arena;
+    }
+
+    void* allocate(std::size_t n) noexcept
+    {
+        if (n == 0 || n > kMaxFrame) return nullptr;
+        const std::size_t c = (n - 1) / kGranule;
+        if (FreeFrame* f = free_[c])
+        {
+            free_[c] = f->next;
+            return f;
+        }
+        const std::size_t size = (c + 1) * kGranule;
+        if (used_ + size > capacity_) return nullptr;
+        void* p = base_ + used_;
+        used_ += size;
+        return p;
+    }
+
+    // p must come from allocate(n) on this arena.
+    void deallocate(void* p, std::size_t n) noexcept
+    {
+        const std::size_t c = (n - 1) / kGranule;
+        free_[c]            = ::new (p) FreeFrame{free_[c]};
+    }
+
+    // Touches every page from the calling thread (first-touch NUMA placement).
+    void prefault() noexcept { std::fill_n(base_, capacity_, std::byte{0}); }
+
+    std::size_t used() const noexcept { return used_; } // carved so far, including free-listed frames
+    std::size_t capacity() const noexcept { return capacity_; }
+
+  private:
+    struct FreeFrame
+    {
+        FreeFrame* next;
+    };
+
+    std::byte*                                   base_;
+    std::size_t                                  capacity_;
+    std::size_t                                  used_{0};
+    std::array<FreeFrame*, kMaxFrame / kGranule> free_{};
+};
@@ -5,349 +5,435 @@
  *  Components
  *  ----------
  *  1. SpscRingBuffer<T, Capacity>  – lock‑free bounded queue (single producer / single consumer)
- *  2. InstrumentStrategyRegistry   – thread‑safe map<InstrumentId, vector<StrategyId>>
- *  3. MarketDataStore              – thread‑safe map<InstrumentId, MarketData>
- *  4. Strategy interface           – Strategy::on_market_data(const MarketData&)
- *  5. StrategyWorker               – owns Strategy* and consumes a ring buffer of tasks
- *  6. ThreadPoolOfStrategies       – N StrategyWorkers, next_worker = (idx++) % N
- *  7. Dispatcher                   – pops MarketDataActions from ingestion_queue,
+ *                                    [spsc_ring_buffer.h]
+ *  2. Domain types, SymbolTable    – dense ids interned from instrument / strategy names
+ *                                    [engine_types.h]
+ *  3. InstrumentStrategyRegistry   – RCU snapshot InstrumentId -> span<StrategyId>,
+ *                                    epoch‑reclaimed, lock‑free lookups
+ *                                    [instrument_strategy_registry.h]
+ *  4. MarketDataStore              – latest MarketData per InstrumentId; seqlock slots,
+ *                                    optionally mapped from a snapshot file for a warm
+ *                                    start, shared_mutex variant kept for comparison
+ *                                    [market_data_store.h]
+ *     OrderBook / OrderBookStore   – L2 depth per instrument: flat tick‑indexed level
+ *                                    arrays + occupancy bitmaps, seqlock reads
+ *                                    [order_book.h]
+ *  5. Strategy interface           – Strategy::on_market_data(const MarketData&), batched
+ *                                    on_market_data(span<const MarketDataAction>),
+ *                                    StaticStrategy<Derived> CRTP base
+ *                                    [strategy.h]
+ *     CoStrategy                   – strategy as a coroutine: co_await ticks, timers and
+ *                                    order acks, frames from a per‑worker FrameArena
+ *                                    [coroutine_strategy.h]
+ *     IndicatorEngine              – EMA / variance / VWAP / z‑score for a whole universe
+ *                                    in SoA columns, AVX‑512 / AVX2 / scalar kernel
+ *                                    picked at runtime [simd_indicators.h]
+ *  6. StrategyWorker               – hosts strategies and consumes a ring buffer of tasks
+ *     ThreadPoolOfStrategies       – N StrategyWorkers, routes each action to the worker
+ *                                    owning its strategy; rebalance() moves a strategy
+ *                                    to another worker without stopping the engine
+ *  7. Dispatcher                   – polls one SPSC lane per feed handler round‑robin,
  *                                    looks up interested strategies,
- *                                    pushes actions to workers in round‑robin
- *  8. MarketDataIngestion          – pushes MarketDataActions to ingestion_queue
+ *                                    pushes one action per (instrument, strategy)
+ *  8. MarketDataIngestion          – feed handler, pushes MarketDataActions to its lane
+ *     ReplayIngestion              – replays an mmapped tick capture, as fast as
+ *                                    possible or at scaled original timing
+ *     ShmIngestion                 – drains a feed handler process's ticks from a
+ *                                    shared‑memory ring into a dispatcher lane
+ *                                    [6‑8: strategy_engine.h]
+ *     TickRecorder / TickFile      – fixed‑record binary capture written off the
+ *                                    hot path, read back via mmap [tick_capture.h]
+ *     ShmRing<T, Capacity>         – SPSC ring in a named shm segment: versioned header,
+ *                                    per‑role attach / detach, crash detection by pid
+ *                                    [shm_ring.h]
+ *     EnginePlacement              – CPU topology from /sys, one core per thread on
+ *                                    one NUMA node [thread_placement.h]
+ *     OrderOutbox                  – per‑worker SPSC ring of OrderIntents; strategies
+ *                                    publish with send_order() [order_outbox.h]
+ *     OrderGateway                 – drains outboxes, lock‑free pre‑trade risk checks,
+ *                                    pluggable OrderSink (stub / file) [order_gateway.h]
+ *     Arena / FrameArena           – per‑thread bump arena for per‑burst scratch,
+ *                                    recycling arena for coroutine frames
+ *                                    [arena.h]
+ *     NoAllocScope                 – operator new hook; counts or aborts on allocations
+ *                                    by warmed‑up engine threads [alloc_guard.h]
+ *     MetricsReporter              – snapshot thread: per‑thread counters and gauges of
+ *                                    every component as one JSON line, to a file or a
+ *                                    Unix socket [metrics.h, engine_metrics.h]
+ *     WorkStealingExecutor         – alternative to the static pool for skewed costs: one
+ *                                    lane per instrument, Chase‑Lev deques, idle workers
+ *                                    steal whole lanes [work_stealing.h]
+ *     TimingWheel                  – per‑thread hierarchical timer wheel, O(1) schedule /
+ *                                    cancel, wall‑clock‑aligned periodics [timing_wheel.h]
  *  9. main()                       – wire everything, mock feed, graceful shutdown
  *
  *  Notes
  *  -----
+ *  * Several feed handlers can feed the dispatcher: each connect()s to its own
+ *    SPSC lane, polled fairly, so ordering holds within a feed.
+ *  * The feed handler can run as its own process (--shm-publish) with the
+ *    engine attached to its ShmRing (--shm-feed); either side can crash and
+ *    be restarted without taking the other down.
  *  * All inter‑thread hand‑off paths are SPSC to stay lock‑free and avoid
- *    cache‑line contention.
- *  * resize() / dynamic allocation is avoided inside the hot path.
- *  * Registry and store are read‑mostly so guarded by shared mutexes.
+ *    cache‑line contention. Consumers drain in bursts of kDrainBatch with a
+ *    single index publication per burst.
+ *  * Workers group each drained burst by strategy and make one virtual call
+ *    per run; StaticStrategy devirtualizes the per‑tick loop inside it.
+ *  * No allocation on the hot path: queues, hold lists and handoff buffers are
+ *    preallocated, strategies get a per‑burst Arena, and every engine thread
+ *    runs its loop inside a NoAllocScope that counts (or aborts on) any
+ *    operator new after warm‑up.
+ *  * Every counter has a single writer that updates it with a plain load and
+ *    store on its own cache line; the metrics thread only reads them, so
+ *    observing the engine costs the hot path nothing extra.
+ *  * Every queue has an OverflowPolicy (drop newest / drop oldest / block with
+ *    timeout / spill) and drop, high‑water and occupancy counters.
+ *  * A worker can swap its tick queue for a ConflatingMailbox that keeps only
+ *    the latest tick per instrument, bounding latency when it lags.
+ *  * Each hop (ingestion->dispatcher, dispatcher->worker, worker->strategy
+ *    return) records into per‑thread log‑bucketed LatencyHistograms, merged
+ *    into p50 / p99 / p99.9 / max reports on demand.
+ *  * Each consuming thread has a WaitPolicy (busy‑spin, spin+yield, or
+ *    spin+futex park with producer‑side wake‑ups) and reports busy / idle time.
+ *  * Engine threads are pinned per EnginePlacement: the whole pipeline sits on
+ *    one NUMA node, ingestion shares the dispatcher's physical core when SMT is
+ *    available, and each consumer first‑touches its own ring so the pages are
+ *    allocated on its node.
+ *  * Each worker and the dispatcher own a TimingWheel, advanced between queue
+ *    drains; strategies get deadlines and periodic timers (set_timer,
+ *    set_periodic, co_await sleep_for) with no timer thread, and a parked
+ *    thread sleeps only until its next timer is due.
+ *  * The gateway answers every order with an OrderAck on the worker's outbox;
+ *    the worker hands it to the strategy, so coroutine strategies resume on
+ *    their own worker with no extra thread or queue.
+ *  * Each order carries the ingestion stamp of the tick that triggered it; the
+ *    gateway records tick‑to‑order latency when the sink returns.
+ *  * Names are interned into dense integer ids at subscribe / registration
+ *    time, so actions on the hot path are trivially copyable PODs.
+ *  * The registry is read‑mostly: readers see an immutable snapshot, writers
+ *    copy and republish it. The quote store is a single‑writer seqlock so
+ *    readers never write shared memory.
+ *  * With --store the quote slots live in a mapped file the dispatcher updates
+ *    in place; a restart maps it and has every recent quote before the first
+ *    tick, rejecting slots torn by a crash or older than five minutes.
  *
  *  Replace placeholders (TODO) with your production implementations
  *  (e.g. subscription logic, FIX connectivity, real strategies, etc.).
  */
 
-#include <atomic>
 #include <array>
-#include <cassert>
 #include <chrono>
-#include <cstddef>
-#include <functional>
 #include <iostream>
-#include <mutex>
-#include <shared_mutex>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
-#include <unordered_map>
-#include <vector>
 
-// ---------- 1. Lock‑free single‑producer / single‑consumer ring buffer -----
+#define ENGINE_INSTALL_ALLOC_HOOK // the one TU that defines the global operator new
+#include "alloc_guard.h"
+#include "coroutine_strategy.h"
+#include "engine_metrics.h"
+#include "order_gateway.h"
+#include "strategy_engine.h"
 
-template <typename T, std::size_t CapacityPow2>
-class SpscRingBuffer
-{
-    static_assert((CapacityPow2 & (CapacityPow2 - 1)) == 0,
-                  "Capacity must be power of two");
-  public:
-    bool push(const T& v) noexcept
-    {
-        const std::size_t head = head_.load(std::memory_order_relaxed);
-        const std::size_t next_head = (head + 1) & mask_;
-        if (next_head == tail_.load(std::memory_order_acquire))
-            return false;                 // queue full
-        buffer_[head] = v;
-        head_.store(next_head, std::memory_order_release);
-        return true;
-    }
-
-    bool pop(T& out) noexcept
-    {
-        const std::size_t tail = tail_.load(std::memory_order_relaxed);
-        if (tail == head_.load(std::memory_order_acquire))
-            return false;                 // queue empty
-        out = buffer_[tail];
-        tail_.store((tail + 1) & mask_, std::memory_order_release);
-        return true;
-    }
-
-  private:
-    static constexpr std::size_t mask_ = CapacityPow2 - 1;
-    std::array<T, CapacityPow2> buffer_{};
-    std::atomic<std::size_t> head_{0};
-    std::atomic<std::size_t> tail_{0};
-};
-
-// ---------- 2. Basic domain types ------------------------------------------
-
-using InstrumentId = std::string;
-using StrategyId   = std::string;
-
-struct MarketData
-{
-    double price{};
-    double size{};
-    std::chrono::steady_clock::time_point ts{};
-};
-
-struct MarketDataAction
-{
-    InstrumentId instrument;
-    MarketData   data;
-};
-
-// ---------- 3. Instrument / Strategy registry ------------------------------
+// ---------- 9. main() -------------------------------------------------------
 
-class InstrumentStrategyRegistry
+int main(int argc, char* argv[])
 {
-  public:
-    void add(const InstrumentId& inst, const StrategyId& sid)
-    {
-        std::unique_lock lock(mtx_);
-        map_[inst].push_back(sid);
-    }
-
-    std::vector<StrategyId> lookup(const InstrumentId& inst) const
+    // --record <file>          capture every tick the dispatcher accepts
+    // --replay <file> [speed]  feed a capture instead of the mock feed;
+    //                          speed 0 (default) = as fast as possible
+    // --orders <file>          write accepted orders to a file instead of a stub
+    // --alloc-abort            abort on any allocation by a warmed-up engine thread
+    // --shm-publish <name> [s] run only the mock feed, publishing into shared
+    //                          memory for s seconds (default 10)
+    // --shm-feed <name>        take ticks from a --shm-publish process instead
+    //                          of the mock feed
+    // --metrics-file <file>    rewrite a JSON metrics snapshot every second
+    // --metrics-socket <path>  answer each connection with a JSON snapshot
+    // --store <file>           keep the latest quotes in a mapped snapshot file,
+    //                          warm-starting from it if a previous run left one
+    std::string record_path;
+    std::string replay_path;
+    std::string orders_path;
+    std::string shm_publish;
+    std::string shm_feed;
+    std::string metrics_file;
+    std::string metrics_socket;
+    std::string store_path;
+    double      replay_speed = 0.0;
+    int         publish_secs = 10;
+    for (int i = 1; i < argc; ++i)
     {
-        std::shared_lock lock(mtx_);
-        auto it = map_.find(inst);
-        return it == map_.end() ? std::vector<StrategyId>{} : it->second;
+        const std::string_view arg = argv[i];
+        if (arg == "--record" && i + 1 < argc)
+            record_path = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc)
+        {
+            replay_path = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') replay_speed = std::stod(argv[++i]);
+        }
+        else if (arg == "--orders" && i + 1 < argc)
+            orders_path = argv[++i];
+        else if (arg == "--alloc-abort")
+            AllocGuard::policy = AllocPolicy::Abort;
+        else if (arg == "--shm-publish" && i + 1 < argc)
+        {
+            shm_publish = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') publish_secs = std::stoi(argv[++i]);
+        }
+        else if (arg == "--shm-feed" && i + 1 < argc)
+            shm_feed = argv[++i];
+        else if (arg == "--metrics-file" && i + 1 < argc)
+            metrics_file = argv[++i];
+        else if (arg == "--metrics-socket" && i + 1 < argc)
+            metrics_socket = argv[++i];
+        else if (arg == "--store" && i + 1 < argc)
+            store_path = argv[++i];
+        else
+        {
+            std::cerr << "usage: " << argv[0]
+                      << " [--record <file>] [--replay <file> [speed]] [--orders <file>] [--alloc-abort]"
+                         " [--shm-publish <name> [seconds] | --shm-feed <name>]"
+                         " [--metrics-file <file>] [--metrics-socket <path>] [--store <file>]\n";
+            return -1;
+        }
     }
 
-  private:
-    mutable std::shared_mutex mtx_;
-    std::unordered_map<InstrumentId, std::vector<StrategyId>> map_;
-};
-
-// ---------- 4. Market data store -------------------------------------------
-
-class MarketDataStore
-{
-  public:
-    void update(const InstrumentId& inst, const MarketData& md)
-    {
-        std::unique_lock lock(mtx_);
-        map_[inst] = md;
-    }
+    // Names are resolved to ids once, here; everything downstream sees ints.
+    SymbolTable instruments;
+    SymbolTable strategies;
+    const InstrumentId ibm  = instruments.intern("IBM");
+    const InstrumentId msft = instruments.intern("MSFT");
 
-    std::optional<MarketData> latest(const InstrumentId& inst) const
+    // Feed handler process: no engine here. Both processes intern IBM and MSFT
+    // first, in this order, so the ids agree across the ring.
+    if (!shm_publish.empty())
     {
-        std::shared_lock lock(mtx_);
-        auto it = map_.find(inst);
-        return it == map_.end() ? std::nullopt : std::optional<MarketData>(it->second);
+        MarketDataShmRing   ring(shm_publish, MarketDataShmRing::Role::Producer);
+        MarketDataIngestion feed(ring);
+        feed.subscribe(ibm);
+        feed.subscribe(msft);
+        std::cout << "publishing to " << shm_publish << " for " << publish_secs << " s\n";
+        std::this_thread::sleep_for(std::chrono::seconds(publish_secs));
+        std::cout << "engine attached at exit: " << (ring.peer_alive() ? "yes" : "no") << ", dropped "
+                  << feed.dropped() << '\n';
+        MarketDataShmRing::unlink(shm_publish);
+        return 0;
     }
 
-  private:
-    mutable std::shared_mutex mtx_;
-    std::unordered_map<InstrumentId, MarketData> map_;
-};
-
-// ---------- 5. Strategy interface -----------------------------------------
-
-class Strategy
-{
-  public:
-    explicit Strategy(StrategyId id): id_(std::move(id)) {}
-    virtual ~Strategy() = default;
-    const StrategyId& id() const noexcept { return id_; }
-    virtual void on_market_data(const MarketData&) = 0;
-
-  private:
-    StrategyId id_;
-};
-
-// Example dummy strategy
-class PrintStrategy final : public Strategy
-{
-  public:
-    using Strategy::Strategy;
-    void on_market_data(const MarketData& md) override
+    // One core per engine thread on a single NUMA node; see EnginePlacement.
+    // Two feed handlers (mock venues), one per instrument, or one replay feed.
+    const std::size_t     n_feeds   = replay_path.empty() && shm_feed.empty() ? 2 : 1;
+    const EnginePlacement placement = EnginePlacement::plan(CpuTopology::detect(), 3, n_feeds);
+    std::cout << "placement: node " << placement.node << ", dispatcher cpu " << placement.dispatcher
+              << ", ingestion cpus";
+    for (const int cpu : placement.ingestion) std::cout << ' ' << cpu;
+    std::cout << ", worker cpus";
+    for (const int cpu : placement.workers) std::cout << ' ' << cpu;
+    std::cout << '\n';
+
+    // Mapped after IBM and MSFT are interned, so their slots are named in the file.
+    const auto      store_start = std::chrono::steady_clock::now();
+    MarketDataStore store       = store_path.empty() ? MarketDataStore() : MarketDataStore(store_path, instruments);
+    if (store.persistent())
     {
-        std::cout << "[Strat " << id() << "] price=" << md.price << '\n';
+        std::cout << "store " << store_path << ": generation " << store.generation() << ", recovered "
+                  << store.recovered() << " quotes in "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                           store_start)
+                         .count()
+                  << " us";
+        for (const InstrumentId inst : {ibm, msft})
+            if (const auto md = store.latest(inst))
+                std::cout << ", " << instruments.name(inst) << ' ' << md->price << " ("
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                   md->ts)
+                                 .count()
+                          << " ms old)";
+        std::cout << '\n';
     }
-};
-
-// ---------- 6. Strategy worker & pool --------------------------------------
-
-class StrategyWorker
-{
-    using Queue = SpscRingBuffer<MarketDataAction, 1 << 12>; // 4096
-
-  public:
-    StrategyWorker(): th_([this] { run(); }) {}
-
-    ~StrategyWorker()
+    // Depth for both instruments, 0.01 tick, window wide enough for the mock's 100-200 range.
+    OrderBookStore books;
+    books.create(ibm, 0.01, 150.0, 1 << 14);
+    books.create(msft, 0.01, 150.0, 1 << 14);
+    // Two spinning workers for the IBM strategies, a parked one for the rest.
+    // The parked worker may fall behind, so it only ever sees the latest price.
+    const std::array<WorkerConfig, 3> worker_cfgs{{
+        {.wait = {WaitPolicy::SpinYield}, .cpu = placement.workers[0]},
+        {.wait = {WaitPolicy::SpinYield}, .cpu = placement.workers[1]},
+        {.wait = {WaitPolicy::SpinPark}, .overflow = {OverflowPolicy::DropOldest}, .conflate = true,
+         .cpu = placement.workers[2]},
+    }};
+    ThreadPoolOfStrategies pool(worker_cfgs);
+    for (std::size_t i = 0; i < pool.size(); ++i)
     {
-        running_.store(false, std::memory_order_relaxed);
-        if (th_.joinable()) th_.join();
+        // For demo each worker starts with one strategy instance; S0 trades IBM.
+        std::string name = "S" + std::to_string(i);
+        const StrategyId sid = strategies.intern(name);
+        if (i == 0)
+            pool.add_strategy(std::make_unique<ThresholdStrategy>(sid, std::move(name), ibm, 110.0, 190.0), i);
+        else
+            pool.add_strategy(std::make_unique<PrintStrategy>(sid, std::move(name)), i);
     }
+    // S3 is a coroutine: buy an IBM dip, exit at 180 or after 5 ms, cool down 10 ms.
+    auto dip = std::make_unique<DipBuyStrategy>(strategies.intern("S3"), "S3", ibm, 120.0, 180.0,
+                                                std::chrono::milliseconds(5), std::chrono::milliseconds(10));
+    const DipBuyStrategy& s3 = *dip;
+    pool.add_strategy(std::move(dip), 0);
+    // S4 publishes an MSFT VWAP every 100 ms of wall clock from the parked worker's timer wheel.
+    auto vwap = std::make_unique<PeriodicVwapStrategy>(strategies.intern("S4"), "S4", std::chrono::milliseconds(100));
+    const PeriodicVwapStrategy& s4 = *vwap;
+    pool.add_strategy(std::move(vwap), 2);
+    // S5 tracks the median IBM price of each burst, sorted in worker 1's scratch Arena.
+    auto median = std::make_unique<BurstMedianStrategy>(strategies.intern("S5"), "S5");
+    const BurstMedianStrategy& s5 = *median;
+    pool.add_strategy(std::move(median), 1);
+
+    // Orders from every worker go through one gateway: risk checks, then the sink.
+    std::unique_ptr<OrderSink> sink;
+    if (orders_path.empty())
+        sink = std::make_unique<StubOrderSink>();
+    else
+        sink = std::make_unique<FileOrderSink>(orders_path);
+    OrderGateway gateway(pool, *sink, {.limits = {.max_order_qty = 10, .max_order_notional = 10'000, .max_position = 5}});
 
-    bool enqueue(const MarketDataAction& a) { return q_.push(a); }
-
-    void attach_strategy(std::shared_ptr<Strategy> s)
+    InstrumentStrategyRegistry registry;
+    registry.add(ibm, strategies.intern("S0"));
+    registry.add(ibm, strategies.intern("S1"));
+    registry.add(msft, strategies.intern("S2"));
+    registry.add(ibm, strategies.intern("S3"));
+    registry.add(msft, strategies.intern("S4"));
+    registry.add(ibm, strategies.intern("S5"));
+
+    std::unique_ptr<TickRecorder> recorder;
+    if (!record_path.empty()) recorder = std::make_unique<TickRecorder>(record_path, instruments);
+    std::optional<TickFile> capture;
+    if (!replay_path.empty()) capture.emplace(replay_path);
+
+    Dispatcher dispatcher(registry, store, pool, {.overflow = {OverflowPolicy::Block},
+                                                 .recorder = recorder.get(),
+                                                 .cpu      = placement.dispatcher,
+                                                 .feeds    = n_feeds,
+                                                 .feed_timeout = std::chrono::milliseconds(50)});
+
+    // Started below, once the metrics reporter can list them.
+    std::array<std::optional<MarketDataIngestion>, 2> feeds;
+    std::optional<ReplayIngestion>                    replay;
+    std::optional<MarketDataShmRing>                  shm_ring;
+    std::optional<ShmIngestion>                       shm_ingest;
+
+    // Declared after the components it reads, so it stops first.
+    std::optional<MetricsReporter> metrics;
+    if (!metrics_file.empty() || !metrics_socket.empty())
     {
-        strategy_ = std::move(s);
+        metrics.emplace(MetricsConfig{.file = metrics_file, .socket = metrics_socket});
+        add_engine_metrics(*metrics, dispatcher, pool, gateway);
     }
 
-  private:
-    void run()
+    if (capture)
+        replay.emplace(dispatcher, *capture, instruments, replay_speed, placement.ingestion[0]);
+    else if (!shm_feed.empty())
     {
-        MarketDataAction a;
-        while (running_.load(std::memory_order_relaxed))
-        {
-            while (q_.pop(a))
-                if (strategy_) strategy_->on_market_data(a.data);
-
-            std::this_thread::yield();
-        }
+        shm_ring.emplace(shm_feed, MarketDataShmRing::Role::Consumer);
+        shm_ingest.emplace(dispatcher, *shm_ring, WaitConfig{}, placement.ingestion[0]);
     }
-
-    std::atomic<bool> running_{true};
-    Queue             q_;
-    std::shared_ptr<Strategy> strategy_;
-    std::thread       th_;
-};
-
-class ThreadPoolOfStrategies
-{
-  public:
-    explicit ThreadPoolOfStrategies(std::size_t n)
-        : workers_(n)
+    else
     {
-        for (std::size_t i = 0; i < n; ++i)
-        {
-            // For demo each worker has its own strategy instance
-            workers_[i].attach_strategy(
-                std::make_shared<PrintStrategy>("S" + std::to_string(i)));
-        }
+        feeds[0].emplace(dispatcher, placement.ingestion[0], &books);
+        feeds[0]->subscribe(ibm);
+        feeds[1].emplace(dispatcher, placement.ingestion[1], &books);
+        feeds[1]->subscribe(msft);
     }
-
-    bool dispatch(const MarketDataAction& a)
+    if (metrics)
     {
-        // round‑robin
-        const std::size_t idx = next_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
-        return workers_[idx].enqueue(a);
+        if (replay) add_feed_metrics(*metrics, "replay", *replay);
+        if (shm_ingest) add_feed_metrics(*metrics, "shm_feed", *shm_ingest);
+        for (std::size_t i = 0; i < feeds.size(); ++i)
+            if (feeds[i]) add_feed_metrics(*metrics, "feed" + std::to_string(i), *feeds[i]);
     }
 
-  private:
-    std::vector<StrategyWorker> workers_;
-    std::atomic<std::size_t>    next_{0};
-};
+    auto report_latency = [&] {
+        std::cout << "latency ingestion->dispatcher " << dispatcher.ingest_to_dispatch().snapshot().report() << '\n'
+                  << "latency dispatcher->worker    " << pool.dispatch_to_worker().report() << '\n'
+                  << "latency worker->return       " << pool.worker_to_return().report() << '\n'
+                  << "latency tick->order          " << gateway.tick_to_order().snapshot().report() << '\n';
+    };
 
-// ---------- 7. Dispatcher ---------------------------------------------------
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    report_latency();
+    // Keep both IBM subscribers on one core from here on.
+    pool.rebalance(strategies.intern("S1"), 0);
 
-class Dispatcher
-{
-    using Queue = SpscRingBuffer<MarketDataAction, 1 << 16>; // 65536
-
-  public:
-    Dispatcher(InstrumentStrategyRegistry& reg,
-               MarketDataStore&           store,
-               ThreadPoolOfStrategies&    pool)
-        : registry_(reg), store_(store), pool_(pool), th_([this]{ run(); })
-    {}
-
-    ~Dispatcher()
-    {
-        running_.store(false, std::memory_order_relaxed);
-        if (th_.joinable()) th_.join();
-    }
-
-    bool accept(const MarketDataAction& a) { return q_.push(a); }
-
-  private:
-    void run()
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (replay)
     {
-        MarketDataAction a;
-        while (running_.load(std::memory_order_relaxed))
-        {
-            while (q_.pop(a))
-            {
-                store_.update(a.instrument, a.data);
-
-                for (const auto& sid : registry_.lookup(a.instrument))
-                {
-                    // (Optional) Embed strategy id inside action if needed
-                    pool_.dispatch(a);
-                }
-            }
-            std::this_thread::yield();
-        }
+        while (!replay->done()) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::cout << "replayed " << replay->replayed() << " ticks\n";
     }
-
-    InstrumentStrategyRegistry& registry_;
-    MarketDataStore&            store_;
-    ThreadPoolOfStrategies&     pool_;
-    Queue                       q_;
-    std::atomic<bool>           running_{true};
-    std::thread                 th_;
-};
-
-// ---------- 8. Market data ingestion ---------------------------------------
-
-class MarketDataIngestion
-{
-    using Queue = SpscRingBuffer<MarketDataAction, 1 << 16>; // 65536
-  public:
-    explicit MarketDataIngestion(Dispatcher& d): dispatcher_(d), th_([this]{ run(); }) {}
-    ~MarketDataIngestion()
+    std::cout << "Shutting down...\n";
     {
-        running_.store(false, std::memory_order_relaxed);
-        if (th_.joinable()) th_.join();
+        std::array<BookLevel, 3> bids, asks;
+        const std::size_t nb = books.find(ibm)->top(Side::Buy, bids);
+        const std::size_t na = books.find(ibm)->top(Side::Sell, asks);
+        std::cout << "IBM book:";
+        for (std::size_t i = 0; i < nb; ++i) std::cout << ' ' << bids[i].qty << '@' << bids[i].price;
+        std::cout << " |";
+        for (std::size_t i = 0; i < na; ++i) std::cout << ' ' << asks[i].qty << '@' << asks[i].price;
+        std::cout << '\n';
     }
-
-    // Called from main thread to subscribe/unsubscribe; mock impl
-    void subscribe(const InstrumentId& inst)
+    report_latency();
+    if (recorder)
+        std::cout << "recorded " << recorder->written() << " ticks, dropped " << recorder->dropped()
+                  << (recorder->failed() ? " (capture write failed)" : "") << '\n';
+
+    auto report = [](const char* who, const ThreadActivity& act) {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        std::cout << who << ": busy " << duration_cast<milliseconds>(act.busy()).count() << " ms, idle "
+                  << duration_cast<milliseconds>(act.idle()).count() << " ms\n";
+    };
+    if (replay) report("replay", replay->activity());
+    if (shm_ingest)
     {
-        subs_.push_back(inst);
+        report("shm ingestion", shm_ingest->activity());
+        std::cout << "shm feed: received " << shm_ingest->received() << " ticks, publisher "
+                  << (shm_ingest->feed_alive() ? "alive" : "gone") << '\n';
     }
-
-  private:
-    void run()
+    for (std::size_t i = 0; i < feeds.size(); ++i)
+        if (feeds[i]) report(("feed " + std::to_string(i)).c_str(), feeds[i]->activity());
+    report("dispatcher", dispatcher.activity());
+    report("gateway", gateway.activity());
+    for (std::size_t i = 0; i < pool.size(); ++i)
+        report(("worker " + std::to_string(i)).c_str(), pool.activity(i));
+
+    auto report_queue = [](const char* who, const QueueStats& q) {
+        std::cout << who << " queue: pushed " << q.pushed << ", dropped " << q.dropped << ", held " << q.held
+                  << ", high water " << q.high_water << "/" << q.capacity << '\n';
+    };
+    for (std::size_t i = 0; i < dispatcher.feeds(); ++i)
     {
-        // Mock: publish random prices every 1 ms
-        while (running_.load(std::memory_order_relaxed))
-        {
-            for (const auto& inst : subs_)
-            {
-                MarketData md{random_price(), 1.0,
-                              std::chrono::steady_clock::now()};
-                dispatcher_.accept({inst, md});
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+        report_queue(("dispatcher feed " + std::to_string(i)).c_str(), dispatcher.queue_stats(i));
+        std::cout << "dispatcher feed " << i << " silent 50 ms intervals: " << dispatcher.feed_stalls(i) << '\n';
     }
-
-    static double random_price()
+    for (std::size_t i = 0; i < pool.size(); ++i)
     {
-        static thread_local uint32_t s = 1234567u;
-        s = s * 1664525u + 1013904223u;
-        return 100.0 + (s % 1000) / 10.0; // 100 – 200
+        report_queue(("worker " + std::to_string(i)).c_str(), pool.queue_stats(i));
+        if (const auto mb = pool.mailbox_stats(i); mb.posted)
+            std::cout << "worker " << i << " mailbox: posted " << mb.posted << ", conflated " << mb.conflated << '\n';
     }
-
-    Dispatcher&                dispatcher_;
-    std::vector<InstrumentId>  subs_;
-    std::atomic<bool>          running_{true};
-    std::thread                th_;
-};
-
-// ---------- 9. main() -------------------------------------------------------
-
-int main()
-{
-    InstrumentStrategyRegistry registry;
-    registry.add("IBM", "S0");
-    registry.add("IBM", "S1");
-    registry.add("MSFT", "S2");
-
-    MarketDataStore store;
-    ThreadPoolOfStrategies pool(/*n=*/3);
-    Dispatcher dispatcher(registry, store, pool);
-    MarketDataIngestion ingestion(dispatcher);
-
-    ingestion.subscribe("IBM");
-    ingestion.subscribe("MSFT");
-
-    std::this_thread::sleep_for(std::chrono::seconds(2));
-    std::cout << "Shutting down...\n";
+    std::cout << "allocations after warm-up: dispatcher " << dispatcher.allocations().count() << ", gateway "
+              << gateway.allocations().count();
+    for (std::size_t i = 0; i < pool.size(); ++i) std::cout << ", worker " << i << ' ' << pool.allocations(i).count();
+    std::cout << '\n';
+
+    const OrderGatewayStats orders = gateway.stats();
+    std::cout << "orders: accepted " << orders.accepted << ", rejected qty " << orders.rejected_qty << ", notional "
+              << orders.rejected_notional << ", position " << orders.rejected_position << ", dropped " << orders.dropped
+              << '\n';
+    std::cout << "S3 (coroutine) round trips: " << s3.round_trips() << '\n';
+    std::cout << "S4 (timer) VWAP publishes: " << s4.publishes() << ", last " << s4.vwap() << '\n';
+    std::cout << "S5 (arena) last burst median: " << s5.median() << '\n';
     return 0; // destructors join threads
 }
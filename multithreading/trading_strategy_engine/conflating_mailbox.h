@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "engine_types.h"
+#include "market_data_store.h"
+#include "spsc_ring_buffer.h"
+
+// ---------- Conflating mailbox for lagging workers -------------------------
+
+/*
+ * Per-worker alternative to a tick queue: at most one pending MarketData per
+ * instrument, overwritten in place, plus a ready list of instruments that have
+ * fresh data. A worker that falls behind skips straight to the latest price
+ * instead of replaying every stale tick, so its queueing delay is bounded by
+ * one pass over the ready list whatever the burst size.
+ *
+ * Single producer (dispatcher) / single consumer (worker):
+ *  * post()  writes the quote (seqlock), sets the strategy's pending bit and,
+ *            if the instrument was not already queued, appends it to the ready
+ *            ring.
+ *  * drain() pops ready instruments, clears their queued flag, then takes the
+ *            pending bits and reads the quote.
+ * The queued flag flips false -> true only in post() and true -> false only
+ * after the consumer has popped the entry, so an instrument is in the ready
+ * ring at most once and a ring of kMaxInstruments never overflows.
+ */
+class ConflatingMailbox
+{
+    static_assert(kMaxStrategies % 64 == 0);
+    static constexpr std::size_t kMaskWords = kMaxStrategies / 64;
+
+  public:
+    struct Stats
+    {
+        std::uint64_t posted{};
+        std::uint64_t conflated{}; // posts that overwrote a tick the worker never saw
+    };
+
+    ConflatingMailbox(): slots_(std::make_unique<Slot[]>(kMaxInstruments)) {}
+
+    // ---- producer side ----
+
+    void post(const MarketDataAction& a) noexcept
+    {
+        assert(a.instrument < kMaxInstruments && a.strategy < kMaxStrategies);
+        Slot& s = slots_[a.instrument];
+        s.quote.write(a.data);
+
+        const std::uint64_t bit  = std::uint64_t{1} << (a.strategy % 64);
+        const std::uint64_t prev = s.pending[a.strategy / 64].fetch_or(bit);
+        if (prev & bit) bump(conflated_);
+        bump(posted_);
+
+        if (!s.queued.exchange(true))
+        {
+            [[maybe_unused]] const bool ok = ready_.push(a.instrument);
+            assert(ok);
+        }
+    }
+
+    // ---- consumer side ----
+
+    // Takes up to max_entries ready instruments and calls fn(instrument,
+    // strategy, data) for each of their pending strategies with the newest data.
+    // Returns the number of calls.
+    template <typename Fn> std::size_t drain(Fn&& fn, std::size_t max_entries = kDrainBatch)
+    {
+        std::array<InstrumentId, kDrainBatch> ready;
+        std::size_t                           calls = 0;
+        while (max_entries)
+        {
+            const std::size_t n = ready_.pop_n(std::span(ready).first(std::min(max_entries, ready.size())));
+            if (n == 0) break;
+            max_entries -= n;
+            for (const InstrumentId inst : std::span(ready).first(n))
+            {
+                Slot& s = slots_[inst];
+                s.queued.store(false);
+
+                std::array<std::uint64_t, kMaskWords> pending;
+                bool                                  any = false;
+                for (std::size_t w = 0; w < kMaskWords; ++w)
+                    any |= (pending[w] = s.pending[w].exchange(0)) != 0;
+                if (!any) continue; // already served through an earlier entry
+
+                const std::optional<MarketData> md = s.quote.read();
+                for (std::size_t w = 0; w < kMaskWords; ++w)
+                {
+                    for (std::uint64_t bits = pending[w]; bits; bits &= bits - 1)
+                    {
+                        fn(inst, static_cast<StrategyId>(w * 64 + std::countr_zero(bits)), *md);
+                        ++calls;
+                    }
+                }
+            }
+        }
+        return calls;
+    }
+
+    bool        empty() const noexcept { return ready_.empty(); }
+    // Before first use; see SpscRingBuffer::prefault().
+    void        prefault() noexcept { ready_.prefault(); }
+    std::size_t ready() const noexcept { return ready_.size(); }
+
+    Stats stats() const noexcept
+    {
+        return {posted_.load(std::memory_order_relaxed), conflated_.load(std::memory_order_relaxed)};
+    }
+
+  private:
+    static void bump(std::atomic<std::uint64_t>& c) noexcept
+    {
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    struct alignas(kCacheLine) Slot
+    {
+        SeqlockQuote                                        quote;
+        std::array<std::atomic<std::uint64_t>, kMaskWords> pending{}; // bit per StrategyId
+        std::atomic<bool>                                   queued{false};
+    };
+
+    std::unique_ptr<Slot[]>                           slots_;
+    SpscRingBuffer<InstrumentId, kMaxInstruments>     ready_;
+    alignas(kCacheLine) std::atomic<std::uint64_t>    posted_{0};
+    std::atomic<std::uint64_t>                        conflated_{0};
+};
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "arena.h"
+#include "engine_types.h"
+#include "strategy.h"
+
+// ---------- Coroutine strategies --------------------------------------------
+
+/*
+ * A strategy written as one coroutine, run(), instead of a callback state
+ * machine. Inside run() it co_awaits
+ *   next_tick(inst)              the next tick for inst (kInvalidId = any),
+ *   sleep_until(t), sleep_for(d) a deadline,
+ *   order_ack(id)                the gateway's verdict on an order from send_order().
+ *
+ * The worker delivers events through the ordinary Strategy entry points and
+ * the coroutine is resumed inline, on the worker thread, inside that call: no
+ * extra thread, queue or hop. One awaiter is pending at a time; an event that
+ * does not match it is not seen by the coroutine, which reads the current
+ * state rather than a history. When run() returns, the next event starts it
+ * again.
+ *
+ * A rebalance() ends the run() in progress on the old worker (see
+ * on_handoff()), so move a coroutine strategy between cycles, with no order
+ * in flight.
+ *
+ * On a worker, a deadline is a timer on the worker's TimingWheel and resumes
+ * the coroutine between bursts even when no tick arrives; an event that finds
+ * the deadline already passed resumes it first. Elsewhere deadlines are only
+ * checked when an event arrives. on_timer is taken for this, so a coroutine
+ * strategy waits with sleep_until / sleep_for rather than set_timer.
+ *
+ * Frames come from the worker's FrameArena and are recycled by size class, so
+ * a run() that restarts every cycle allocates nothing after its first frame.
+ * Off a worker thread, or when the arena is full, frames come from the heap.
+ * A coroutine that throws terminates the process.
+ */
+class CoStrategy : public Strategy
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct TickEvent
+    {
+        InstrumentId instrument{kInvalidId}; // kInvalidId when delivered without one
+        MarketData   data;
+    };
+
+    class Task
+    {
+      public:
+        struct promise_type
+        {
+            Task                get_return_object() noexcept { return Task(Handle::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void                return_void() noexcept {}
+            void                unhandled_exception() noexcept { std::terminate(); }
+
+            // A header in front of the frame records which arena it came from
+            // (nullptr = heap). FrameArena is single-threaded, so a frame is
+            // only destroyed on the worker that owns its arena; on_handoff()
+            // destroys it there before a rebalance() moves the strategy.
+            static void* operator new(std::size_t n)
+            {
+                FrameArena* arena = FrameArena::current();
+                void*       p     = arena ? arena->allocate(n + kHeader) : nullptr;
+                if (!p)
+                {
+                    p     = ::operator new(n + kHeader);
+                    arena = nullptr;
+                }
+                ::new (p) FrameArena*(arena);
+                return static_cast<std::byte*>(p) + kHeader;
+            }
+            static void operator delete(void* frame, std::size_t n) noexcept
+            {
+                void*             p     = static_cast<std::byte*>(frame) - kHeader;
+                FrameArena* const arena = *static_cast<FrameArena**>(p);
+                if (arena)
+                    arena->deallocate(p, n + kHeader);
+                else
+                    ::operator delete(p);
+            }
+        };
+
+        Task() noexcept = default;
+        Task(Task&& o) noexcept: h_(std::exchange(o.h_, {})) {}
+        Task& operator=(Task&& o) noexcept
+        {
+            reset();
+            h_ = std::exchange(o.h_, {});
+            return *this;
+        }
+        ~Task() { reset(); }
+
+      private:
+        friend class CoStrategy;
+        using Handle = std::coroutine_handle<promise_type>;
+        static constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+        explicit Task(Handle h) noexcept: h_(h) {}
+        void reset() noexcept
+        {
+            if (h_) std::exchange(h_, {}).destroy();
+        }
+
+        Handle h_;
+    };
+
+    using Strategy::Strategy;
+
+    void on_market_data(const MarketData& md) final { on_tick({kInvalidId, md}); }
+    void on_market_data(std::span<const MarketDataAction> batch) final
+    {
+        for (const MarketDataAction& a : batch) on_tick({a.instrument, a.data});
+    }
+    void on_order_ack(const OrderAck& ack) final
+    {
+        start_if_done();
+        fire_timer();
+        if (wait_ == Wait::Ack && (want_order_ == 0 || want_order_ == ack.order_id))
+        {
+            ack_ = ack;
+            resume();
+        }
+    }
+    void on_timer(TimerId id, std::uint64_t) final
+    {
+        if (wait_ != Wait::Timer || id != timer_) return;
+        timer_ = kNoTimer;
+        resume();
+    }
+    // Abandons the cycle in progress: the deadline's timer is cancelled on,
+    // and the frame returned to, the old worker; the new worker's first event
+    // starts run() afresh with a frame from its own arena.
+    void on_handoff() final
+    {
+        cancel_timer(std::exchange(timer_, kNoTimer));
+        task_.reset();
+        wait_ = Wait::None;
+    }
+
+  protected:
+    virtual Task run() = 0;
+
+    struct TickAwaiter
+    {
+        CoStrategy&  s;
+        InstrumentId inst;
+        bool         await_ready() const noexcept { return false; }
+        void         await_suspend(std::coroutine_handle<>) const noexcept
+        {
+            s.wait_      = Wait::Tick;
+            s.want_inst_ = inst;
+        }
+        TickEvent    await_resume() const noexcept { return s.tick_; }
+    };
+    struct TimerAwaiter
+    {
+        CoStrategy&       s;
+        Clock::time_point deadline;
+        bool              await_ready() const noexcept { return Clock::now() >= deadline; }
+        void              await_suspend(std::coroutine_handle<>) const noexcept
+        {
+            s.wait_     = Wait::Timer;
+            s.deadline_ = deadline;
+            s.timer_    = s.set_timer(deadline);
+        }
+        void              await_resume() const noexcept {}
+    };
+    struct AckAwaiter
+    {
+        CoStrategy&   s;
+        std::uint64_t order_id;
+        bool          await_ready() const noexcept { return false; }
+        void          await_suspend(std::coroutine_handle<>) const noexcept
+        {
+            s.wait_       = Wait::Ack;
+            s.want_order_ = order_id;
+        }
+        OrderAck      await_resume() const noexcept { return s.ack_; }
+    };
+
+    TickAwaiter  next_tick(InstrumentId inst = kInvalidId) noexcept { return {*this, inst}; }
+    TimerAwaiter sleep_until(Clock::time_point t) noexcept { return {*this, t}; }
+    TimerAwaiter sleep_for(Clock::duration d) noexcept { return {*this, Clock::now() + d}; }
+    // order_id 0 = the next ack for any order.
+    AckAwaiter   order_ack(std::uint64_t order_id) noexcept { return {*this, order_id}; }
+
+  private:
+    enum class Wait : std::uint8_t
+    {
+        None,
+        Tick,
+        Timer,
+        Ack,
+    };
+
+    void resume()
+    {
+        wait_ = Wait::None;
+        task_.h_.resume();
+    }
+
+    // run() is (re)started lazily, on the worker thread, so its frame comes
+    // from that worker's arena.
+    void start_if_done()
+    {
+        if (task_.h_ && !task_.h_.done()) return;
+        task_.reset(); // free the old frame first so the new one can reuse it
+        task_ = run();
+        resume();
+    }
+
+    void fire_timer()
+    {
+        if (wait_ != Wait::Timer || Clock::now() < deadline_) return;
+        cancel_timer(std::exchange(timer_, kNoTimer));
+        resume();
+    }
+
+    void on_tick(const TickEvent& t)
+    {
+        start_if_done();
+        fire_timer();
+        if (wait_ == Wait::Tick && (want_inst_ == kInvalidId || want_inst_ == t.instrument))
+        {
+            tick_ = t;
+            resume();
+        }
+    }
+
+    Task              task_;
+    Wait              wait_{Wait::None};
+    InstrumentId      want_inst_{kInvalidId};
+    std::uint64_t     want_order_{0};
+    Clock::time_point deadline_{};
+    TimerId           timer_{kNoTimer}; // wheel timer behind deadline_, if any
+    TickEvent         tick_{};
+    OrderAck          ack_{};
+};
+
+// Example coroutine strategy: buys a dip below entry, exits at target or
+// after hold, then waits out cooldown before looking for the next dip.
+class DipBuyStrategy final : public CoStrategy
+{
+  public:
+    DipBuyStrategy(StrategyId id, std::string name, InstrumentId inst, double entry, double target,
+                   Clock::duration hold, Clock::duration cooldown, double qty = 1.0)
+        : CoStrategy(id, std::move(name)), inst_(inst), entry_(entry), target_(target), hold_(hold),
+          cooldown_(cooldown), qty_(qty)
+    {}
+
+    // Any thread.
+    std::uint64_t round_trips() const noexcept { return round_trips_.load(std::memory_order_relaxed); }
+
+  private:
+    Task run() override
+    {
+        TickEvent t;
+        do t = co_await next_tick(inst_);
+        while (t.data.price >= entry_);
+
+        const std::uint64_t entry = send_order(t.data, inst_, Side::Buy, t.data.price, qty_);
+        if (!entry || (co_await order_ack(entry)).status != OrderStatus::Accepted) co_return;
+
+        const Clock::time_point give_up = Clock::now() + hold_;
+        do t = co_await next_tick(inst_);
+        while (t.data.price < target_ && Clock::now() < give_up);
+
+        if (const std::uint64_t exit = send_order(t.data, inst_, Side::Sell, t.data.price, qty_))
+            co_await order_ack(exit);
+        round_trips_.store(round_trips_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        co_await sleep_for(cooldown_);
+    }
+
+    InstrumentId               inst_;
+    double                     entry_, target_;
+    Clock::duration            hold_, cooldown_;
+    double                     qty_;
+    std::atomic<std::uint64_t> round_trips_{0};
+};
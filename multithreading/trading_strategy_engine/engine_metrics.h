@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "latency_histogram.h"
+#include "metrics.h"
+#include "order_gateway.h"
+#include "strategy_engine.h"
+
+// ---------- Engine metrics sources ------------------------------------------
+
+namespace engine_metrics
+{
+inline void activity(MetricsWriter& w, const ThreadActivity& a)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    w.field("busy_us", static_cast<std::int64_t>(duration_cast<microseconds>(a.busy()).count()));
+    w.field("idle_us", static_cast<std::int64_t>(duration_cast<microseconds>(a.idle()).count()));
+}
+
+// Gauges (depth) next to the running totals.
+inline void queue(MetricsWriter& w, const char* name, const QueueStats& q)
+{
+    w.begin(name);
+    w.field("depth", q.occupancy);
+    w.field("pushed", q.pushed);
+    w.field("dropped", q.dropped);
+    w.field("held", q.held);
+    w.field("high_water", q.high_water);
+    w.end();
+}
+
+inline void latency(MetricsWriter& w, const char* name, const LatencyHistogram::Snapshot& s)
+{
+    const LatencyHistogram::Report r = s.report();
+    w.begin(name);
+    w.field("n", r.count);
+    w.field("p50_ns", r.p50);
+    w.field("p99_ns", r.p99);
+    w.field("p999_ns", r.p999);
+    w.field("max_ns", r.max);
+    w.end();
+}
+} // namespace engine_metrics
+
+/*
+ * Registers the dispatcher, every worker and the gateway with reporter, as
+ * "dispatcher", "worker<i>" and "gateway". Everything is read from counters
+ * the engine threads already publish; the sources run on the reporter's
+ * thread. The components must outlive reporter.
+ */
+inline void add_engine_metrics(MetricsReporter& reporter, Dispatcher& dispatcher, ThreadPoolOfStrategies& pool,
+                               OrderGateway& gateway)
+{
+    using namespace engine_metrics;
+
+    reporter.add("dispatcher", [&dispatcher](MetricsWriter& w) {
+        const DispatcherCounters& c = dispatcher.counters();
+        w.field("ticks", c.ticks.value());
+        w.field("routed", c.routed.value());
+        w.field("bursts", c.bursts.value());
+        w.field("allocs", dispatcher.allocations().count());
+        activity(w, dispatcher.activity());
+        latency(w, "ingest_to_dispatch", dispatcher.ingest_to_dispatch().snapshot());
+        for (std::size_t i = 0; i < dispatcher.feeds(); ++i)
+        {
+            const std::string feed = "feed" + std::to_string(i);
+            queue(w, feed.c_str(), dispatcher.queue_stats(i));
+            w.field((feed + "_stalls").c_str(), dispatcher.feed_stalls(i));
+        }
+    });
+
+    for (std::size_t i = 0; i < pool.size(); ++i)
+        reporter.add("worker" + std::to_string(i), [&pool, i](MetricsWriter& w) {
+            const WorkerCounters& c = pool.counters(i);
+            w.field("ticks", c.ticks.value());
+            w.field("bursts", c.bursts.value());
+            w.field("acks", c.acks.value());
+            w.field("stray_acks", c.stray_acks.value());
+            w.field("timers", c.timers.value());
+            w.field("allocs", pool.allocations(i).count());
+            activity(w, pool.activity(i));
+            queue(w, "queue", pool.queue_stats(i));
+            if (const ConflatingMailbox::Stats mb = pool.mailbox_stats(i); mb.posted)
+            {
+                w.field("mailbox_posted", mb.posted);
+                w.field("mailbox_conflated", mb.conflated);
+            }
+            w.field("orders_dropped", pool.outbox(i).dropped());
+            w.field("acks_dropped", pool.outbox(i).acks_dropped());
+        });
+
+    reporter.add("pool", [&pool](MetricsWriter& w) {
+        w.field("park_stalls", pool.park_stalls());
+        latency(w, "dispatch_to_worker", pool.dispatch_to_worker());
+        latency(w, "worker_to_return", pool.worker_to_return());
+    });
+
+    reporter.add("gateway", [&gateway](MetricsWriter& w) {
+        const OrderGatewayStats s = gateway.stats();
+        w.field("accepted", s.accepted);
+        w.field("rejected_qty", s.rejected_qty);
+        w.field("rejected_notional", s.rejected_notional);
+        w.field("rejected_position", s.rejected_position);
+        w.field("dropped", s.dropped);
+        w.field("allocs", gateway.allocations().count());
+        activity(w, gateway.activity());
+        latency(w, "tick_to_order", gateway.tick_to_order().snapshot());
+    });
+}
+
+/*
+ * Registers one ingestion thread (MarketDataIngestion, ShmIngestion or
+ * ReplayIngestion) with reporter as component: ticks published into the
+ * engine, ticks dropped because the lane or ring was full, and busy / idle
+ * time. feed must outlive reporter.
+ */
+template <typename Feed> inline void add_feed_metrics(MetricsReporter& reporter, std::string component, const Feed& feed)
+{
+    using namespace engine_metrics;
+
+    reporter.add(std::move(component), [&feed](MetricsWriter& w) {
+        const IngestionCounters& c = feed.counters();
+        w.field("published", c.published.value());
+        w.field("dropped", c.dropped.value());
+        activity(w, feed.activity());
+    });
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "platform.h"
+#include "spsc_ring_buffer.h"
+
+// ---------- Engine queue: SPSC ring + overflow policy + counters -----------
+
+enum class OverflowPolicy : std::uint8_t
+{
+    DropNewest, // reject the incoming element
+    DropOldest, // hold overflow on the producer side, evicting its oldest entry
+    Block,      // spin until there is room or block_timeout passes, then drop newest
+    Spill,      // hold overflow on the producer side without bound
+};
+
+struct OverflowConfig
+{
+    OverflowPolicy            policy{OverflowPolicy::DropNewest};
+    std::chrono::microseconds block_timeout{100}; // Block
+    std::size_t               hold_limit{1024};   // DropOldest bound; DropOldest / Spill preallocate this much
+};
+
+// Point-in-time copy of a queue's counters.
+struct QueueStats
+{
+    std::uint64_t pushed{};     // elements that entered the ring
+    std::uint64_t dropped{};    // elements lost to the overflow policy
+    std::uint64_t held{};       // elements waiting on the producer side right now
+    std::uint64_t high_water{}; // deepest backlog the consumer has found
+    std::uint64_t occupancy{};  // elements in the ring right now
+    std::uint64_t capacity{};
+};
+
+/*
+ * SpscRingBuffer plus what the engine needs around it in production: a
+ * per-queue overflow policy and counters readable at runtime.
+ *
+ * Elements already in the ring belong to the consumer, so overflow that is not
+ * dropped outright waits in a producer-side hold list. Once anything is held,
+ * later offers queue behind it so order is preserved, and the producer must
+ * call flush() from its loop to move held elements in as the consumer frees
+ * room. DropOldest evicts from that hold list, i.e. it drops the oldest element
+ * the consumer has not been handed yet.
+ *
+ * Counters are single-writer (producer or consumer) relaxed atomics updated
+ * with a load and a store, never an RMW, and each side's counters sit on that
+ * side's cache line.
+ */
+template <typename T, std::size_t CapacityPow2>
+class EngineQueue
+{
+  public:
+    explicit EngineQueue(OverflowConfig cfg = {})
+        : cfg_(cfg), held_(cfg.policy == OverflowPolicy::DropOldest || cfg.policy == OverflowPolicy::Spill ? cfg.hold_limit : 0)
+    {}
+
+    // ---- producer side ----
+
+    bool offer(const T& v)
+    {
+        if (!held_.empty())
+        {
+            flush();
+            if (!held_.empty()) return hold(v);
+        }
+        if (q_.push(v))
+        {
+            bump(pushed_);
+            return true;
+        }
+        switch (cfg_.policy)
+        {
+        case OverflowPolicy::DropNewest:
+            bump(dropped_);
+            return false;
+        case OverflowPolicy::Block:
+            return block(v);
+        case OverflowPolicy::DropOldest:
+        case OverflowPolicy::Spill:
+            return hold(v);
+        }
+        return false;
+    }
+
+    // Control-path push that bypasses the overflow policy: never counted as a
+    // drop, queues behind anything held. Callers retry until it succeeds.
+    bool try_put(const T& v)
+    {
+        flush();
+        if (!held_.empty() || !q_.push(v)) return false;
+        bump(pushed_);
+        return true;
+    }
+
+    // Moves held elements into the ring while it has room.
+    void flush()
+    {
+        std::size_t moved = 0;
+        while (!held_.empty() && q_.push(held_.front()))
+        {
+            held_.pop_front();
+            ++moved;
+        }
+        if (moved)
+        {
+            bump(pushed_, moved);
+            held_count_.store(held_.size(), std::memory_order_relaxed);
+        }
+    }
+
+    bool has_held() const noexcept { return !held_.empty(); }
+
+    // ---- consumer side ----
+
+    std::size_t pop_n(std::span<T> out) noexcept
+    {
+        const std::size_t n = q_.pop_n(out);
+        if (n)
+        {
+            const std::uint64_t backlog = n + q_.size();
+            if (backlog > high_water_.load(std::memory_order_relaxed))
+                high_water_.store(backlog, std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    bool empty() const noexcept { return q_.empty(); }
+
+    // Before first use; see SpscRingBuffer::prefault().
+    void prefault() noexcept { q_.prefault(); }
+
+    // ---- any thread ----
+
+    QueueStats stats() const noexcept
+    {
+        return {pushed_.load(std::memory_order_relaxed),   dropped_.load(std::memory_order_relaxed),
+                held_count_.load(std::memory_order_relaxed), high_water_.load(std::memory_order_relaxed),
+                q_.size(),                                  CapacityPow2};
+    }
+
+  private:
+    // Producer-private FIFO for overflow: a ring that doubles when full and
+    // never shrinks. Once it has grown to the deepest backlog seen it stops
+    // allocating, unlike a std::deque, which frees and reallocates blocks as
+    // it fills and drains.
+    class HoldList
+    {
+      public:
+        explicit HoldList(std::size_t reserve): buf_(std::bit_ceil(std::max<std::size_t>(reserve, 16))) {}
+
+        bool        empty() const noexcept { return size_ == 0; }
+        std::size_t size() const noexcept { return size_; }
+        const T&    front() const noexcept { return buf_[head_]; }
+        void        pop_front() noexcept
+        {
+            head_ = (head_ + 1) & (buf_.size() - 1);
+            --size_;
+        }
+        void push_back(const T& v)
+        {
+            if (size_ == buf_.size()) grow();
+            buf_[(head_ + size_++) & (buf_.size() - 1)] = v;
+        }
+
+      private:
+        void grow()
+        {
+            std::vector<T> next(buf_.size() * 2);
+            for (std::size_t i = 0; i < size_; ++i) next[i] = std::move(buf_[(head_ + i) & (buf_.size() - 1)]);
+            buf_.swap(next);
+            head_ = 0;
+        }
+
+        std::vector<T> buf_;
+        std::size_t    head_{0};
+        std::size_t    size_{0};
+    };
+
+    static void bump(std::atomic<std::uint64_t>& c, std::uint64_t by = 1) noexcept
+    {
+        c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    bool hold(const T& v)
+    {
+        if (cfg_.policy == OverflowPolicy::DropOldest && held_.size() >= cfg_.hold_limit)
+        {
+            held_.pop_front();
+            bump(dropped_);
+        }
+        held_.push_back(v);
+        held_count_.store(held_.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+    bool block(const T& v)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + cfg_.block_timeout;
+        do
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                cpu_relax();
+                if (q_.push(v))
+                {
+                    bump(pushed_);
+                    return true;
+                }
+            }
+        } while (std::chrono::steady_clock::now() < deadline);
+        bump(dropped_);
+        return false;
+    }
+
+    SpscRingBuffer<T, CapacityPow2> q_;
+
+    // producer line
+    alignas(kCacheLine) const OverflowConfig cfg_;
+    HoldList                                 held_;
+    std::atomic<std::uint64_t>               pushed_{0};
+    std::atomic<std::uint64_t>               dropped_{0};
+    std::atomic<std::uint64_t>               held_count_{0};
+    // consumer line
+    alignas(kCacheLine) std::atomic<std::uint64_t> high_water_{0};
+};
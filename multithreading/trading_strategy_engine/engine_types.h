@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "platform.h"
+
+// ---------- 2. Basic domain types ------------------------------------------
+
+// Dense handles handed out by SymbolTable; they index flat tables directly.
+using InstrumentId = std::uint32_t;
+using StrategyId   = std::uint32_t;
+
+inline constexpr std::uint32_t kInvalidId      = std::numeric_limits<std::uint32_t>::max();
+inline constexpr std::size_t   kMaxStrategies  = 256;
+inline constexpr std::size_t   kMaxInstruments = 4096;
+inline constexpr std::size_t   kDrainBatch     = 64; // max actions taken off a queue per index publication
+
+struct MarketData
+{
+    double price{};
+    double size{};
+    std::chrono::steady_clock::time_point ts{};
+};
+
+enum class ActionKind : std::uint8_t
+{
+    Tick,
+    Handoff, // control marker: the strategy is moving off this worker
+};
+
+struct MarketDataAction
+{
+    InstrumentId instrument{kInvalidId};
+    StrategyId   strategy{kInvalidId};
+    ActionKind   kind{ActionKind::Tick};
+    MarketData   data;
+    std::chrono::steady_clock::time_point dispatched{}; // stamped by the dispatcher, for latency histograms
+};
+
+static_assert(std::is_trivially_copyable_v<MarketDataAction>,
+              "hot-path actions must stay PODs (no strings, no heap)");
+
+enum class Side : std::uint8_t
+{
+    Buy,
+    Sell,
+};
+
+// What a strategy wants to trade; the order gateway decides whether it goes out.
+struct OrderIntent
+{
+    StrategyId   strategy{kInvalidId};
+    InstrumentId instrument{kInvalidId};
+    Side         side{Side::Buy};
+    double       price{};
+    double       qty{};
+    std::chrono::steady_clock::time_point tick_ts{}; // MarketData::ts of the triggering tick
+    std::uint64_t id{};                               // per strategy, from send_order(); 0 = none
+};
+
+static_assert(std::is_trivially_copyable_v<OrderIntent>);
+
+enum class OrderStatus : std::uint8_t
+{
+    Accepted,
+    RejectedQty,
+    RejectedNotional,
+    RejectedPosition,
+};
+
+// Gateway's verdict on an OrderIntent, sent back to the worker that sent it.
+struct OrderAck
+{
+    StrategyId    strategy{kInvalidId};
+    OrderStatus   status{OrderStatus::Accepted};
+    std::uint64_t order_id{};
+};
+
+static_assert(std::is_trivially_copyable_v<OrderAck>);
+
+// Name <-> id interning. Only touched on the cold path (subscribe, registration,
+// logging); the hot path carries the integer ids alone.
+class SymbolTable
+{
+  public:
+    std::uint32_t intern(std::string_view name)
+    {
+        std::unique_lock lock(mtx_);
+        auto [it, inserted] = ids_.try_emplace(std::string(name), static_cast<std::uint32_t>(names_.size()));
+        if (inserted) names_.push_back(it->first);
+        return it->second;
+    }
+
+    std::optional<std::uint32_t> find(std::string_view name) const
+    {
+        std::shared_lock lock(mtx_);
+        auto it = ids_.find(std::string(name));
+        return it == ids_.end() ? std::nullopt : std::optional<std::uint32_t>(it->second);
+    }
+
+    // deque never relocates its elements, so the reference outlives the lock
+    const std::string& name(std::uint32_t id) const
+    {
+        std::shared_lock lock(mtx_);
+        return names_.at(id);
+    }
+
+    std::size_t size() const
+    {
+        std::shared_lock lock(mtx_);
+        return names_.size();
+    }
+
+  private:
+    mutable std::shared_mutex                      mtx_;
+    std::deque<std::string>                        names_;
+    std::unordered_map<std::string, std::uint32_t> ids_;
+};
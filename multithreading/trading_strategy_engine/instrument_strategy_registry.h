@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "engine_types.h"
+
+// ---------- 3. Instrument / Strategy registry ------------------------------
+
+/*
+ * Read-copy-update registry.
+ *
+ *  * Readers pin an epoch, load the current immutable Snapshot through an
+ *    atomic pointer and get non-owning spans out of it: no lock, no
+ *    allocation, no copy.
+ *  * add() / remove() are rare: under a writer mutex they rebuild a Snapshot,
+ *    swap it in and retire the old one.
+ *  * A retired Snapshot is freed once every registered reader is either
+ *    quiescent or pinned at an epoch that started after the swap, so nobody
+ *    can still be holding it (epoch-based reclamation).
+ *
+ * Each reader thread claims one slot with register_reader() and holds at most
+ * one ReadGuard on it at a time. Pinning costs one seq_cst store, so readers
+ * take a guard per drain burst rather than per tick.
+ */
+class InstrumentStrategyRegistry
+{
+    // Flat CSR layout: strategies of instrument i are ids_[offsets_[i] .. offsets_[i + 1]).
+    struct Snapshot
+    {
+        std::vector<std::uint32_t> offsets{0};
+        std::vector<StrategyId>    ids;
+
+        std::span<const StrategyId> lookup(InstrumentId inst) const noexcept
+        {
+            if (inst + 1 >= offsets.size()) return {};
+            return {ids.data() + offsets[inst], ids.data() + offsets[inst + 1]};
+        }
+    };
+
+    static constexpr std::size_t   kMaxReaders = 16;
+    static constexpr std::uint64_t kQuiescent  = 0;
+
+  public:
+    class ReadGuard
+    {
+      public:
+        ReadGuard(const ReadGuard&)            = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ~ReadGuard() { epoch_.store(kQuiescent, std::memory_order_release); }
+
+        // Valid until the guard is destroyed.
+        std::span<const StrategyId> lookup(InstrumentId inst) const noexcept { return snap_->lookup(inst); }
+
+      private:
+        friend class InstrumentStrategyRegistry;
+        ReadGuard(std::atomic<std::uint64_t>& epoch, const Snapshot* snap): epoch_(epoch), snap_(snap) {}
+
+        std::atomic<std::uint64_t>& epoch_;
+        const Snapshot*             snap_;
+    };
+
+    InstrumentStrategyRegistry(): current_(new Snapshot{}) {}
+
+    ~InstrumentStrategyRegistry()
+    {
+        delete current_.load(std::memory_order_relaxed);
+        for (const Retired& r : retired_) delete r.snap;
+    }
+
+    InstrumentStrategyRegistry(const InstrumentStrategyRegistry&)            = delete;
+    InstrumentStrategyRegistry& operator=(const InstrumentStrategyRegistry&) = delete;
+
+    // Cold path, once per reader thread.
+    std::size_t register_reader()
+    {
+        std::lock_guard lock(write_mtx_);
+        assert(readers_ < kMaxReaders);
+        return readers_++;
+    }
+
+    ReadGuard read(std::size_t reader) const noexcept
+    {
+        std::atomic<std::uint64_t>& slot = slots_[reader].epoch;
+        // seq_cst on both: the pin must be visible before we look at current_,
+        // otherwise a writer could swap and free the snapshot we are about to load.
+        slot.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        return ReadGuard(slot, current_.load(std::memory_order_seq_cst));
+    }
+
+    void add(InstrumentId inst, StrategyId sid)
+    {
+        std::lock_guard lock(write_mtx_);
+        if (inst >= table_.size()) table_.resize(inst + 1);
+        table_[inst].push_back(sid);
+        publish();
+    }
+
+    void remove(InstrumentId inst, StrategyId sid)
+    {
+        std::lock_guard lock(write_mtx_);
+        if (inst >= table_.size()) return;
+        std::erase(table_[inst], sid);
+        publish();
+    }
+
+  private:
+    struct alignas(kCacheLine) ReaderSlot
+    {
+        std::atomic<std::uint64_t> epoch{kQuiescent};
+    };
+
+    struct Retired
+    {
+        const Snapshot* snap;
+        std::uint64_t   epoch; // first epoch whose readers cannot see snap
+    };
+
+    // Called with write_mtx_ held.
+    void publish()
+    {
+        auto* next = new Snapshot{};
+        for (const auto& subs : table_)
+        {
+            next->ids.insert(next->ids.end(), subs.begin(), subs.end());
+            next->offsets.push_back(static_cast<std::uint32_t>(next->ids.size()));
+        }
+
+        const Snapshot* old = current_.exchange(next, std::memory_order_seq_cst);
+        retired_.push_back({old, epoch_.fetch_add(1, std::memory_order_seq_cst) + 1});
+        reclaim();
+    }
+
+    void reclaim()
+    {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+        for (std::size_t i = 0; i < readers_; ++i)
+        {
+            const std::uint64_t e = slots_[i].epoch.load(std::memory_order_seq_cst);
+            if (e != kQuiescent) oldest = std::min(oldest, e);
+        }
+        std::erase_if(retired_, [oldest](const Retired& r) {
+            if (r.epoch > oldest) return false;
+            delete r.snap;
+            return true;
+        });
+    }
+
+    mutable std::array<ReaderSlot, kMaxReaders> slots_;
+    alignas(kCacheLine) std::atomic<const Snapshot*> current_;
+    std::atomic<std::uint64_t>                       epoch_{1};
+
+    // Writer side, guarded by write_mtx_.
+    alignas(kCacheLine) std::mutex       write_mtx_;
+    std::size_t                          readers_{0};
+    std::vector<std::vector<StrategyId>> table_; // source of truth, indexed by InstrumentId
+    std::vector<Retired>                 retired_;
+};
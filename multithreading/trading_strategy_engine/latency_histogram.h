@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// ---------- Log-bucketed latency histograms --------------------------------
+
+/*
+ * HDR-style layout: values below 2^kSubBits ns get one bucket each, every
+ * power of two above that is split into 2^kSubBits linear sub-buckets, so the
+ * relative error stays under 1 / 2^kSubBits (~3%) from 1 ns up to ~18 minutes.
+ *
+ * One histogram per recording thread. record() is a bucket index computation
+ * plus a relaxed load/store on a line only that thread writes: no RMW, no
+ * sharing. Readers copy the counters into a Snapshot whenever they like and
+ * merge snapshots from several threads; a snapshot taken mid-flight may be off
+ * by the few samples recorded while it was being copied.
+ */
+class LatencyHistogram
+{
+  public:
+    static constexpr unsigned    kSubBits   = 5;
+    static constexpr unsigned    kMaxBits   = 40;
+    static constexpr std::size_t kSubCount  = std::size_t{1} << kSubBits;
+    static constexpr std::size_t kBuckets   = (kMaxBits - kSubBits + 1) * kSubCount;
+    static constexpr std::uint64_t kMaxValue = (std::uint64_t{1} << kMaxBits) - 1;
+
+    struct Report
+    {
+        std::uint64_t count{};
+        std::uint64_t p50{}, p99{}, p999{}, max{}; // nanoseconds, bucket upper bounds
+    };
+
+    struct Snapshot
+    {
+        std::array<std::uint64_t, kBuckets> counts{};
+        std::uint64_t                       max{};
+
+        Snapshot& operator+=(const Snapshot& o) noexcept
+        {
+            for (std::size_t i = 0; i < kBuckets; ++i) counts[i] += o.counts[i];
+            max = std::max(max, o.max);
+            return *this;
+        }
+
+        Report report() const noexcept
+        {
+            Report r;
+            for (const std::uint64_t c : counts) r.count += c;
+            r.max = max;
+            if (r.count == 0) return r;
+            r.p50  = percentile(r.count, 0.50);
+            r.p99  = percentile(r.count, 0.99);
+            r.p999 = percentile(r.count, 0.999);
+            return r;
+        }
+
+      private:
+        std::uint64_t percentile(std::uint64_t total, double q) const noexcept
+        {
+            const auto    rank = static_cast<std::uint64_t>(q * static_cast<double>(total - 1)) + 1;
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < kBuckets; ++i)
+                if ((seen += counts[i]) >= rank) return std::min(upper_bound(i), max);
+            return max;
+        }
+    };
+
+    // Owner thread only. n > 1 records the same latency for n samples, e.g. a
+    // batch that completed together.
+    void record(std::uint64_t ns, std::uint64_t n = 1) noexcept
+    {
+        ns = std::min(ns, kMaxValue);
+        auto& c = counts_[index(ns)];
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        if (ns > max_.load(std::memory_order_relaxed)) max_.store(ns, std::memory_order_relaxed);
+    }
+
+    void record(std::chrono::steady_clock::duration d, std::uint64_t n = 1) noexcept
+    {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        record(ns > 0 ? static_cast<std::uint64_t>(ns) : 0, n);
+    }
+
+    // Any thread.
+    Snapshot snapshot() const noexcept
+    {
+        Snapshot s;
+        for (std::size_t i = 0; i < kBuckets; ++i) s.counts[i] = counts_[i].load(std::memory_order_relaxed);
+        s.max = max_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    static constexpr std::size_t index(std::uint64_t v) noexcept
+    {
+        if (v < kSubCount) return static_cast<std::size_t>(v);
+        const unsigned shift = static_cast<unsigned>(std::bit_width(v)) - 1 - kSubBits;
+        return (shift + 1) * kSubCount + static_cast<std::size_t>((v >> shift) - kSubCount);
+    }
+
+    static constexpr std::uint64_t upper_bound(std::size_t i) noexcept
+    {
+        if (i < kSubCount) return i;
+        const std::size_t   shift = i / kSubCount - 1;
+        const std::uint64_t sub   = i % kSubCount + kSubCount;
+        return ((sub + 1) << shift) - 1;
+    }
+
+  private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> counts_{};
+    std::atomic<std::uint64_t>                       max_{0};
+};
+
+inline std::ostream& operator<<(std::ostream& os, const LatencyHistogram::Report& r)
+{
+    return os << "n=" << r.count << " p50=" << r.p50 << "ns p99=" << r.p99 << "ns p99.9=" << r.p999
+              << "ns max=" << r.max << "ns";
+}
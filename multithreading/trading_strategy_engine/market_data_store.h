@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "engine_types.h"
+
+// ---------- 4. Market data store -------------------------------------------
+
+// Reference implementation: every update takes the writer lock, every read the
+// shared lock. Kept for benchmarks/market_data_store_benchmark.cpp.
+class SharedMutexMarketDataStore
+{
+  public:
+    void update(InstrumentId inst, const MarketData& md)
+    {
+        std::unique_lock lock(mtx_);
+        if (inst >= table_.size()) table_.resize(inst + 1);
+        table_[inst] = md;
+    }
+
+    std::optional<MarketData> latest(InstrumentId inst) const
+    {
+        std::shared_lock lock(mtx_);
+        return inst < table_.size() ? table_[inst] : std::nullopt;
+    }
+
+  private:
+    mutable std::shared_mutex              mtx_;
+    std::vector<std::optional<MarketData>> table_; // indexed by InstrumentId
+};
+
+/*
+ * One MarketData behind a seqlock.
+ *
+ *  * Single writer: bump seq to odd, write the fields, bump seq to even. It
+ *    never waits on anybody.
+ *  * Readers load seq, copy the fields, and retry if seq was odd or changed.
+ *    They only ever read the slot, so the line stays Shared in every reader's
+ *    cache until the next update.
+ *
+ * Fields are relaxed atomics rather than plain doubles so the racy copy a
+ * reader may discard is still well defined. check folds the final seq and
+ * the fields together; readers ignore it, it lets a store mapped from a file tell a
+ * complete slot from one torn by a crash (see intact()).
+ */
+struct SeqlockQuote
+{
+    // A few single-cycle ops, so update() barely notices it.
+    static std::uint64_t checksum(std::uint64_t s, double p, double q, std::int64_t t) noexcept
+    {
+        return s ^ std::rotl(std::bit_cast<std::uint64_t>(p), 17) ^ std::rotl(std::bit_cast<std::uint64_t>(q), 41) ^
+               std::rotl(static_cast<std::uint64_t>(t), 7) ^ 0x9E3779B97F4A7C15ull;
+    }
+
+    void write(const MarketData& md) noexcept
+    {
+        const std::uint64_t s = seq.load(std::memory_order_relaxed);
+        const std::int64_t  t = md.ts.time_since_epoch().count();
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        price.store(md.price, std::memory_order_relaxed);
+        size.store(md.size, std::memory_order_relaxed);
+        ts.store(t, std::memory_order_relaxed);
+        check.store(checksum(s + 2, md.price, md.size, t), std::memory_order_relaxed);
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // Written, not mid-write, and the fields match check. Only meaningful with
+    // no writer running, e.g. on a slot found in a file at startup.
+    bool intact() const noexcept
+    {
+        const std::uint64_t s = seq.load(std::memory_order_relaxed);
+        return s != 0 && (s & 1) == 0 &&
+               check.load(std::memory_order_relaxed) ==
+                   checksum(s, price.load(std::memory_order_relaxed), size.load(std::memory_order_relaxed),
+                            ts.load(std::memory_order_relaxed));
+    }
+
+    std::optional<MarketData> read() const noexcept
+    {
+        for (;;)
+        {
+            const std::uint64_t before = seq.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                cpu_relax(); // writer mid-update
+                continue;
+            }
+            MarketData md{price.load(std::memory_order_relaxed),
+                          size.load(std::memory_order_relaxed),
+                          std::chrono::steady_clock::time_point(
+                              std::chrono::steady_clock::duration(ts.load(std::memory_order_relaxed)))};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == before)
+                return before == 0 ? std::nullopt : std::optional<MarketData>(md);
+        }
+    }
+
+    std::atomic<std::uint64_t> seq{0}; // 0 = never written, odd = write in progress
+    std::atomic<double>        price{0.0};
+    std::atomic<double>        size{0.0};
+    std::atomic<std::int64_t>  ts{0};
+    std::atomic<std::uint64_t> check{0};
+};
+
+/*
+ * Snapshot file layout (native structs, one cache line each):
+ *
+ *   MarketDataSnapshotHeader
+ *   Slot[capacity]            SeqlockQuote + instrument name; index = id in
+ *                             the process that last opened the file
+ *
+ * The header is only written at open: cleared first, then the slots are
+ * rebuilt, then the header is stored with check last. A process that dies
+ * part way leaves a header that fails check and the next start is cold.
+ */
+struct alignas(kCacheLine) MarketDataSnapshotHeader
+{
+    static constexpr std::array<char, 8> kMagic{'M', 'D', 'S', 'T', 'O', 'R', 'E', '1'};
+    static constexpr std::uint32_t       kVersion = 1;
+
+    std::array<char, 8> magic{kMagic};
+    std::uint32_t       version{kVersion};
+    std::uint32_t       slot_size{};
+    std::uint64_t       capacity{};
+    std::uint64_t       generation{};     // opens of this file so far
+    std::int64_t        steady_to_wall{}; // system_clock - steady_clock (ns) of the writing process
+    std::uint64_t       check{};          // over all of the above
+
+    std::uint64_t checksum() const noexcept
+    {
+        constexpr auto mix = [](std::uint64_t h, std::uint64_t w) {
+            h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+            return h ^ (h >> 29);
+        };
+        std::uint64_t h = mix(0, std::bit_cast<std::uint64_t>(magic));
+        h = mix(h, (std::uint64_t{version} << 32) | slot_size);
+        h = mix(h, capacity);
+        h = mix(h, generation);
+        return mix(h, static_cast<std::uint64_t>(steady_to_wall));
+    }
+};
+
+/*
+ * One SeqlockQuote per instrument in a flat array sized up front; each slot
+ * owns a cache line so updates to one instrument don't invalidate readers of
+ * its neighbours.
+ *
+ * Persistent mode maps the slots from a snapshot file (MAP_SHARED) instead,
+ * so the dispatcher's updates land in the page cache as it makes them and
+ * survive the process; nothing is serialised, ever. At startup the file is
+ * mapped and each slot kept if
+ *  * the header matches this layout and its check (else the file is reset),
+ *  * the slot is intact(): not torn by a crash mid-update,
+ *  * the quote is at most max_age old in wall-clock time.
+ * Surviving quotes are moved to the slot of their instrument's id in this
+ * process (interning the name if needed) and restamped onto this process's
+ * steady_clock, so latest() returns them before the first tick arrives.
+ *
+ * The file holds names for the instruments interned when it was opened;
+ * bind() any interned later. One process per file: opening a file another
+ * live store has open throws.
+ */
+class SeqlockMarketDataStore
+{
+    struct Slot;
+
+  public:
+    explicit SeqlockMarketDataStore(std::size_t capacity = kMaxInstruments)
+        : capacity_(capacity), heap_(std::make_unique<Slot[]>(capacity)), slots_(heap_.get())
+    {}
+
+    // Throws std::system_error when the file cannot be opened or mapped,
+    // std::runtime_error when another process has it open.
+    SeqlockMarketDataStore(const std::string& path, SymbolTable& instruments,
+                           std::chrono::seconds max_age = std::chrono::minutes(5),
+                           std::size_t          capacity = kMaxInstruments)
+        : capacity_(capacity), map_size_(sizeof(MarketDataSnapshotHeader) + capacity * sizeof(Slot))
+    {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) throw std::system_error(errno, std::generic_category(), "MarketDataStore: cannot open " + path);
+        if (::flock(fd_, LOCK_EX | LOCK_NB) != 0)
+        {
+            ::close(fd_);
+            throw std::runtime_error("MarketDataStore: " + path + " is in use by another process");
+        }
+        struct stat st{};
+        ::fstat(fd_, &st);
+        const bool sized = static_cast<std::size_t>(st.st_size) == map_size_;
+        if (!sized && ::ftruncate(fd_, static_cast<off_t>(map_size_)) != 0)
+        {
+            const int err = errno;
+            ::close(fd_);
+            throw std::system_error(err, std::generic_category(), "MarketDataStore: ftruncate " + path);
+        }
+        map_ = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, 0);
+        if (map_ == MAP_FAILED)
+        {
+            const int err = errno;
+            ::close(fd_);
+            throw std::system_error(err, std::generic_category(), "MarketDataStore: mmap " + path);
+        }
+        slots_ = reinterpret_cast<Slot*>(static_cast<char*>(map_) + sizeof(MarketDataSnapshotHeader));
+        recover(sized, instruments, max_age);
+    }
+
+    ~SeqlockMarketDataStore()
+    {
+        if (!map_) return;
+        ::munmap(map_, map_size_);
+        ::close(fd_); // drops the lock
+    }
+
+    SeqlockMarketDataStore(const SeqlockMarketDataStore&)            = delete;
+    SeqlockMarketDataStore& operator=(const SeqlockMarketDataStore&) = delete;
+
+    void update(InstrumentId inst, const MarketData& md) noexcept
+    {
+        assert(inst < capacity_);
+        slots_[inst].quote.write(md);
+    }
+
+    std::optional<MarketData> latest(InstrumentId inst) const noexcept
+    {
+        if (inst >= capacity_) return std::nullopt;
+        return slots_[inst].quote.read();
+    }
+
+    // Cold path. Names inst in the snapshot so its quote survives a restart;
+    // no-op for an in-memory store. Names are cut to 15 characters.
+    void bind(InstrumentId inst, std::string_view name) noexcept
+    {
+        if (!map_ || inst >= capacity_) return;
+        std::array<char, 16> n{};
+        name.copy(n.data(), n.size() - 1);
+        slots_[inst].name = n;
+    }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    // Persistent mode only: opens of the file including this one, and how many
+    // quotes were recovered from it.
+    bool          persistent() const noexcept { return map_ != nullptr; }
+    std::uint64_t generation() const noexcept { return map_ ? header().generation : 0; }
+    std::size_t   recovered() const noexcept { return recovered_; }
+
+  private:
+    struct alignas(kCacheLine) Slot
+    {
+        SeqlockQuote         quote;
+        std::array<char, 16> name{}; // NUL-padded; empty = not bound
+    };
+    static_assert(sizeof(Slot) == kCacheLine && sizeof(MarketDataSnapshotHeader) == kCacheLine);
+
+    MarketDataSnapshotHeader& header() const noexcept { return *static_cast<MarketDataSnapshotHeader*>(map_); }
+
+    static std::int64_t steady_to_wall() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch() -
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Runs before any other thread sees the store.
+    void recover(bool sized, SymbolTable& instruments, std::chrono::seconds max_age)
+    {
+        struct Saved
+        {
+            std::string name;
+            MarketData  md;
+        };
+        MarketDataSnapshotHeader& h = header();
+        const std::int64_t        offset = steady_to_wall();
+        const bool valid = sized && h.magic == MarketDataSnapshotHeader::kMagic &&
+                           h.version == MarketDataSnapshotHeader::kVersion && h.slot_size == sizeof(Slot) &&
+                           h.capacity == capacity_ && h.check == h.checksum();
+
+        // Keep what passes, in this process's steady_clock.
+        std::vector<Saved> saved;
+        if (valid)
+        {
+            const std::int64_t oldest =
+                offset + std::chrono::steady_clock::now().time_since_epoch().count() -
+                std::chrono::duration_cast<std::chrono::nanoseconds>(max_age).count();
+            for (std::size_t i = 0; i < capacity_; ++i)
+            {
+                const Slot& s = slots_[i];
+                if (s.name[0] == '\0' || !s.quote.intact()) continue;
+                const std::int64_t wall = s.quote.ts.load(std::memory_order_relaxed) + h.steady_to_wall;
+                if (wall < oldest) continue;
+                saved.push_back({std::string(s.name.data(), ::strnlen(s.name.data(), s.name.size())),
+                                 MarketData{s.quote.price.load(std::memory_order_relaxed),
+                                            s.quote.size.load(std::memory_order_relaxed),
+                                            std::chrono::steady_clock::time_point(
+                                                std::chrono::steady_clock::duration(wall - offset))}});
+            }
+        }
+
+        const std::uint64_t generation = valid ? h.generation + 1 : 1;
+        h.check                        = 0; // invalid until the slots are rebuilt
+        std::memset(static_cast<void*>(slots_), 0, capacity_ * sizeof(Slot));
+        for (const Saved& s : saved)
+            if (const InstrumentId id = instruments.intern(s.name); id < capacity_)
+            {
+                slots_[id].quote.write(s.md);
+                ++recovered_;
+            }
+        for (std::size_t id = 0; id < std::min(instruments.size(), capacity_); ++id)
+            bind(static_cast<InstrumentId>(id), instruments.name(static_cast<std::uint32_t>(id)));
+
+        h.magic          = MarketDataSnapshotHeader::kMagic;
+        h.version        = MarketDataSnapshotHeader::kVersion;
+        h.slot_size      = sizeof(Slot);
+        h.capacity       = capacity_;
+        h.generation     = generation;
+        h.steady_to_wall = offset;
+        h.check          = h.checksum();
+    }
+
+    std::size_t             capacity_;
+    std::unique_ptr<Slot[]> heap_;             // in-memory mode
+    void*                   map_{nullptr};     // persistent mode: header, then the slots
+    std::size_t             map_size_{0};
+    int                     fd_{-1};           // held open for the flock
+    std::size_t             recovered_{0};
+    Slot*                   slots_{nullptr};
+};
+
+// The store the engine runs with. Swap the alias to compare modes end to end.
+using MarketDataStore = SeqlockMarketDataStore;
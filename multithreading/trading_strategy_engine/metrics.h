@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "platform.h"
+#include "thread_placement.h"
+
+// ---------- Runtime metrics -------------------------------------------------
+
+// Single-writer event count. The owning thread adds with a plain load and
+// store, no lock-prefixed read-modify-write; any thread may read. Group a
+// thread's counters in a struct aligned to kCacheLine so no other thread
+// writes their line.
+class Counter
+{
+  public:
+    void          add(std::uint64_t n = 1) noexcept { v_.store(v_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    std::uint64_t value() const noexcept { return v_.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<std::uint64_t> v_{0};
+};
+
+/*
+ * Builds one compact JSON object. Sources write fields and may open nested
+ * objects; keys are plain identifiers and are not escaped.
+ */
+class MetricsWriter
+{
+  public:
+    void begin(std::string_view name)
+    {
+        key(name);
+        out_ += '{';
+        comma_ = false;
+    }
+    void end()
+    {
+        out_ += '}';
+        comma_ = true;
+    }
+
+    void field(std::string_view name, std::uint64_t v) { number(name, v); }
+    void field(std::string_view name, std::int64_t v) { number(name, v); }
+    void field(std::string_view name, double v) { number(name, v); }
+    void field(std::string_view name, bool v)
+    {
+        key(name);
+        out_ += v ? "true" : "false";
+    }
+
+  private:
+    friend class MetricsReporter;
+
+    void key(std::string_view name)
+    {
+        if (comma_) out_ += ',';
+        comma_ = true;
+        out_ += '"';
+        out_ += name;
+        out_ += "\":";
+    }
+    template <typename V> void number(std::string_view name, V v)
+    {
+        key(name);
+        char buf[32];
+        out_.append(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+    }
+
+    std::string out_;
+    bool        comma_{false};
+};
+
+struct MetricsConfig
+{
+    std::chrono::milliseconds period{1000};
+    std::string               file;   // rewritten every period (write + rename); empty = off
+    std::string               socket; // Unix socket path; each connection gets a fresh snapshot; empty = off
+    int                       cpu{-1};
+};
+
+/*
+ * The snapshot thread. Components register a source that reads their
+ * counters and gauges (queue depths, busy time, histogram percentiles) into a
+ * MetricsWriter; every period the thread builds
+ *
+ *   {"seq":N,"uptime_ms":T,"<component>":{...},...}
+ *
+ * and replaces cfg.file with it, and it answers each connection to
+ * cfg.socket with a snapshot taken at that moment, e.g.
+ *   socat - UNIX-CONNECT:/tmp/engine.metrics
+ *
+ * Sources only read what their owners publish with relaxed stores, so the
+ * engine threads never wait for this one and pay nothing per snapshot. All
+ * formatting, allocation and I/O happen here.
+ */
+class MetricsReporter
+{
+    using Clock = std::chrono::steady_clock;
+
+  public:
+    using Source = std::function<void(MetricsWriter&)>;
+
+    explicit MetricsReporter(MetricsConfig cfg): cfg_(std::move(cfg))
+    {
+        if (!cfg_.socket.empty()) listen_fd_ = open_socket(cfg_.socket);
+        th_ = std::thread([this] { run(); });
+    }
+
+    ~MetricsReporter()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        if (th_.joinable()) th_.join();
+        if (listen_fd_ >= 0)
+        {
+            ::close(listen_fd_);
+            ::unlink(cfg_.socket.c_str());
+        }
+    }
+
+    MetricsReporter(const MetricsReporter&)            = delete;
+    MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+    // Cold path; component must be a plain identifier. The objects the source
+    // reads must outlive this reporter, or be removed with remove().
+    void add(std::string component, Source source)
+    {
+        const std::lock_guard lock(mu_);
+        sources_.emplace_back(std::move(component), std::move(source));
+    }
+    void remove(std::string_view component)
+    {
+        const std::lock_guard lock(mu_);
+        std::erase_if(sources_, [&](const auto& s) { return s.first == component; });
+    }
+
+    // Any thread.
+    std::string snapshot()
+    {
+        MetricsWriter w;
+        w.out_ += '{';
+        w.field("seq", seq_.fetch_add(1, std::memory_order_relaxed));
+        w.field("uptime_ms", static_cast<std::int64_t>(
+                                 std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_).count()));
+        {
+            const std::lock_guard lock(mu_);
+            for (const auto& [name, source] : sources_)
+            {
+                w.begin(name);
+                source(w);
+                w.end();
+            }
+        }
+        w.out_ += "}\n";
+        return std::move(w.out_);
+    }
+
+  private:
+    static int open_socket(const std::string& path)
+    {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path))
+            throw std::system_error(ENAMETOOLONG, std::generic_category(), "MetricsReporter: socket path " + path);
+        path.copy(addr.sun_path, path.size());
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "MetricsReporter: socket");
+        ::unlink(path.c_str()); // a stale socket left by a previous run
+        if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 8) != 0)
+        {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "MetricsReporter: cannot listen on " + path);
+        }
+        return fd;
+    }
+
+    void write_file(const std::string& text) const
+    {
+        const std::string tmp = cfg_.file + ".tmp";
+        if (std::FILE* f = std::fopen(tmp.c_str(), "w"))
+        {
+            const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+            if (std::fclose(f) == 0 && ok) std::rename(tmp.c_str(), cfg_.file.c_str()); // readers never see half a file
+        }
+    }
+
+    void serve_one()
+    {
+        const int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) return;
+        const std::string text = snapshot();
+        for (std::size_t done = 0; done < text.size();)
+        {
+            const ssize_t n = ::send(client, text.data() + done, text.size() - done, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            done += static_cast<std::size_t>(n);
+        }
+        ::close(client);
+    }
+
+    void run()
+    {
+        pin_current_thread(cfg_.cpu);
+        Clock::time_point next = Clock::now();
+        while (running_.load(std::memory_order_relaxed))
+        {
+            const Clock::time_point now = Clock::now();
+            if (now >= next)
+            {
+                if (!cfg_.file.empty()) write_file(snapshot());
+                next = now + cfg_.period;
+            }
+            // Wake at least every 100 ms to notice shutdown.
+            const auto wait = std::min(std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now()),
+                                       std::chrono::milliseconds(100));
+            if (listen_fd_ < 0)
+            {
+                std::this_thread::sleep_for(wait);
+                continue;
+            }
+            pollfd pfd{listen_fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, static_cast<int>(std::max<std::int64_t>(wait.count(), 0))) > 0) serve_one();
+        }
+    }
+
+    const MetricsConfig        cfg_;
+    const Clock::time_point    start_{Clock::now()};
+    int                        listen_fd_{-1};
+    std::mutex                 mu_; // sources_: add() / remove() against snapshots
+    std::vector<std::pair<std::string, Source>> sources_;
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<bool>          running_{true};
+    std::thread                th_;
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "engine_types.h"
+#include "platform.h"
+
+// ---------- L2 order book: flat price ladders behind a seqlock -------------
+
+struct BookLevel
+{
+    double price{};
+    double qty{};
+};
+
+/*
+ * Aggregated depth for one instrument. Each side is a preallocated array of
+ * quantities indexed by tick offset from base_, plus an occupancy bitmap with
+ * one bit per level. The best level of each side is cached; when it empties
+ * the next one is found with a bit scan, a word (64 levels) at a time, and
+ * top-N walks the bitmap the same way. No nodes, no allocation after
+ * construction.
+ *
+ * Single writer (the thread that owns the instrument's feed); any number of
+ * readers. Writes bump seq_ to odd, change the arrays, bump it to even, like
+ * SeqlockQuote; readers copy what they need and retry if seq_ moved. All
+ * fields are relaxed atomics so a discarded copy is still well defined.
+ *
+ * The window covers levels ticks centred on the reference price. Updates
+ * outside it are counted and ignored, except on an empty book, which re-centres
+ * on the incoming price.
+ */
+class OrderBook
+{
+  public:
+    OrderBook(double tick_size, double ref_price, std::size_t levels = 4096)
+        : tick_(tick_size), levels_((levels + 63) / 64 * 64), words_(levels_ / 64)
+    {
+        assert(tick_size > 0 && levels > 0);
+        for (std::size_t k = 0; k < 2; ++k)
+        {
+            qty_[k]  = std::make_unique<std::atomic<double>[]>(levels_);
+            bits_[k] = std::make_unique<std::atomic<std::uint64_t>[]>(words_);
+        }
+        centre(ref_price);
+    }
+
+    OrderBook(const OrderBook&)            = delete;
+    OrderBook& operator=(const OrderBook&) = delete;
+
+    // ---- writer side ----
+
+    // qty is added to / replaces / clears the level's aggregate quantity.
+    // False if price is outside the window.
+    bool add(Side s, double price, double qty) noexcept
+    {
+        return update(s, price, [qty](double q) { return q + qty; });
+    }
+    bool modify(Side s, double price, double qty) noexcept
+    {
+        return update(s, price, [qty](double) { return qty; });
+    }
+    bool remove(Side s, double price) noexcept { return modify(s, price, 0.0); }
+
+    // ---- readers (any thread) ----
+
+    // Copies up to out.size() best levels of side s, best first; returns the count.
+    std::size_t top(Side s, std::span<BookLevel> out) const noexcept
+    {
+        const std::size_t k = index(s);
+        for (;;)
+        {
+            const std::uint64_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                cpu_relax();
+                continue;
+            }
+            const std::int64_t base = base_.load(std::memory_order_relaxed);
+            std::size_t        n    = 0;
+            for (std::int64_t i = best_[k].load(std::memory_order_relaxed); i >= 0 && n < out.size();
+                 i = s == Side::Buy ? highest_at_or_below(k, i - 1) : lowest_at_or_above(k, i + 1))
+                out[n++] = {static_cast<double>(base + i) * tick_, qty_[k][i].load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) return n;
+        }
+    }
+
+    double        tick_size() const noexcept { return tick_; }
+    std::size_t   levels() const noexcept { return levels_; }
+    std::uint64_t out_of_window() const noexcept { return out_of_window_.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr std::size_t index(Side s) noexcept { return s == Side::Buy ? 0 : 1; }
+
+    bool empty() const noexcept
+    {
+        return best_[0].load(std::memory_order_relaxed) < 0 && best_[1].load(std::memory_order_relaxed) < 0;
+    }
+
+    void centre(double price) noexcept
+    {
+        base_.store(std::llround(price / tick_) - static_cast<std::int64_t>(levels_ / 2), std::memory_order_relaxed);
+        best_[0].store(-1, std::memory_order_relaxed);
+        best_[1].store(-1, std::memory_order_relaxed);
+    }
+
+    template <typename F> bool update(Side s, double price, F&& next_qty) noexcept
+    {
+        std::int64_t i = std::llround(price / tick_) - base_.load(std::memory_order_relaxed);
+        const bool   inside = i >= 0 && i < static_cast<std::int64_t>(levels_);
+        if (!inside && !empty())
+        {
+            out_of_window_.store(out_of_window_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if (!inside)
+        {
+            centre(price);
+            i = std::llround(price / tick_) - base_.load(std::memory_order_relaxed);
+        }
+        const std::size_t           k    = index(s);
+        std::atomic<double>&        q    = qty_[k][i];
+        std::atomic<std::uint64_t>& w    = bits_[k][i / 64];
+        const std::uint64_t         bit  = std::uint64_t{1} << (i % 64);
+        const double                qty  = next_qty(q.load(std::memory_order_relaxed));
+        const std::int64_t          best = best_[k].load(std::memory_order_relaxed);
+        if (qty > 0)
+        {
+            q.store(qty, std::memory_order_relaxed);
+            w.store(w.load(std::memory_order_relaxed) | bit, std::memory_order_relaxed);
+            if (best < 0 || (s == Side::Buy ? i > best : i < best)) best_[k].store(i, std::memory_order_relaxed);
+        }
+        else
+        {
+            q.store(0.0, std::memory_order_relaxed);
+            w.store(w.load(std::memory_order_relaxed) & ~bit, std::memory_order_relaxed);
+            if (i == best)
+                best_[k].store(s == Side::Buy ? highest_at_or_below(k, i) : lowest_at_or_above(k, i),
+                               std::memory_order_relaxed);
+        }
+
+        seq_.store(seq + 2, std::memory_order_release);
+        return true;
+    }
+
+    // Occupied level nearest to from, scanning down (bids) or up (asks); -1 if none.
+    std::int64_t highest_at_or_below(std::size_t k, std::int64_t from) const noexcept
+    {
+        if (from < 0) return -1;
+        std::size_t   w    = static_cast<std::size_t>(from) / 64;
+        std::uint64_t word = bits_[k][w].load(std::memory_order_relaxed) & (~std::uint64_t{0} >> (63 - from % 64));
+        for (;;)
+        {
+            if (word) return static_cast<std::int64_t>(w * 64 + 63 - std::countl_zero(word));
+            if (w == 0) return -1;
+            word = bits_[k][--w].load(std::memory_order_relaxed);
+        }
+    }
+
+    std::int64_t lowest_at_or_above(std::size_t k, std::int64_t from) const noexcept
+    {
+        if (from >= static_cast<std::int64_t>(levels_)) return -1;
+        std::size_t   w    = static_cast<std::size_t>(from) / 64;
+        std::uint64_t word = bits_[k][w].load(std::memory_order_relaxed) & (~std::uint64_t{0} << (from % 64));
+        for (;;)
+        {
+            if (word) return static_cast<std::int64_t>(w * 64 + std::countr_zero(word));
+            if (++w == words_) return -1;
+            word = bits_[k][w].load(std::memory_order_relaxed);
+        }
+    }
+
+    const double      tick_;
+    const std::size_t levels_;
+    const std::size_t words_;
+
+    // writer-updated header, read by every reader on every copy
+    alignas(kCacheLine) std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::int64_t>                      base_{0}; // price ticks of level 0
+    std::array<std::atomic<std::int64_t>, 2>       best_{};  // level index per side, -1 = empty
+    std::atomic<std::uint64_t>                     out_of_window_{0};
+
+    std::array<std::unique_ptr<std::atomic<double>[]>, 2>        qty_;  // [bid, ask][level]
+    std::array<std::unique_ptr<std::atomic<std::uint64_t>[]>, 2> bits_; // [bid, ask][level / 64]
+};
+
+// One OrderBook per instrument that has depth, created on the cold path.
+class OrderBookStore
+{
+  public:
+    OrderBookStore(): books_(std::make_unique<std::atomic<OrderBook*>[]>(kMaxInstruments)) {}
+
+    // Before the instrument's feed starts writing.
+    OrderBook& create(InstrumentId inst, double tick_size, double ref_price, std::size_t levels = 4096)
+    {
+        assert(inst < kMaxInstruments && !find(inst));
+        owned_.push_back(std::make_unique<OrderBook>(tick_size, ref_price, levels));
+        books_[inst].store(owned_.back().get(), std::memory_order_release);
+        return *owned_.back();
+    }
+
+    OrderBook* find(InstrumentId inst) const noexcept
+    {
+        return inst < kMaxInstruments ? books_[inst].load(std::memory_order_acquire) : nullptr;
+    }
+
+  private:
+    std::unique_ptr<std::atomic<OrderBook*>[]> books_;
+    std::vector<std::unique_ptr<OrderBook>>    owned_;
+};
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cerrno>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "alloc_guard.h"
+#include "engine_types.h"
+#include "latency_histogram.h"
+#include "order_outbox.h"
+#include "strategy_engine.h"
+#include "thread_placement.h"
+#include "wait_strategy.h"
+
+// ---------- Order gateway: risk checks and sinks ---------------------------
+
+// Where accepted orders go. Called on the gateway thread only.
+class OrderSink
+{
+  public:
+    virtual ~OrderSink() = default;
+    virtual void send(const OrderIntent& o) = 0;
+};
+
+// In-process stub: counts what it was given.
+class StubOrderSink final : public OrderSink
+{
+  public:
+    void send(const OrderIntent&) override
+    {
+        sent_.store(sent_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    std::uint64_t sent() const noexcept { return sent_.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<std::uint64_t> sent_{0};
+};
+
+// One text line per order, buffered by stdio.
+class FileOrderSink final : public OrderSink
+{
+  public:
+    explicit FileOrderSink(const std::string& path): file_(std::fopen(path.c_str(), "w"))
+    {
+        if (!file_) throw std::system_error(errno, std::generic_category(), "FileOrderSink: cannot open " + path);
+    }
+    ~FileOrderSink() { std::fclose(file_); }
+
+    FileOrderSink(const FileOrderSink&)            = delete;
+    FileOrderSink& operator=(const FileOrderSink&) = delete;
+
+    void send(const OrderIntent& o) override
+    {
+        std::fprintf(file_, "%lld strategy=%u instrument=%u %s %g@%g\n",
+                     static_cast<long long>(o.tick_ts.time_since_epoch().count()), o.strategy, o.instrument,
+                     o.side == Side::Buy ? "BUY" : "SELL", o.qty, o.price);
+    }
+
+  private:
+    std::FILE* file_;
+};
+
+// Pre-trade limits; 0 disables a check.
+struct RiskLimits
+{
+    double max_order_qty{0};
+    double max_order_notional{0}; // price * qty of one order
+    double max_position{0};       // |net accepted qty| per instrument, over all strategies
+};
+
+struct OrderGatewayConfig
+{
+    WaitConfig wait{};
+    RiskLimits limits{};
+    int        cpu{-1}; // pin target
+};
+
+struct OrderGatewayStats
+{
+    std::uint64_t accepted{};
+    std::uint64_t rejected_qty{};      // malformed, or over max_order_qty
+    std::uint64_t rejected_notional{};
+    std::uint64_t rejected_position{};
+    std::uint64_t dropped{}; // outbox full, never reached the gateway
+};
+
+/*
+ * Drains every worker's OrderOutbox round-robin, applies RiskLimits, hands
+ * accepted orders to the sink and sends an OrderAck for every order back
+ * through the same outbox. Positions live on the gateway thread alone, so
+ * the checks take no locks and need no atomics. An accepted order counts
+ * toward the position immediately (no fills in this skeleton), which errs on
+ * the safe side.
+ *
+ * tick_to_order() is measured from the triggering tick's ingestion stamp to the
+ * return of OrderSink::send().
+ */
+class OrderGateway
+{
+    using Clock = std::chrono::steady_clock;
+
+  public:
+    OrderGateway(ThreadPoolOfStrategies& pool, OrderSink& sink, const OrderGatewayConfig& cfg = {})
+        : pool_(pool), sink_(sink), cfg_(cfg), positions_(std::make_unique<double[]>(kMaxInstruments)),
+          th_([this] { run(); })
+    {}
+
+    ~OrderGateway()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        pool_.order_bell().wake();
+        if (th_.joinable()) th_.join();
+    }
+
+    OrderGatewayStats stats() const noexcept
+    {
+        OrderGatewayStats s{accepted_.load(std::memory_order_relaxed), rejected_qty_.load(std::memory_order_relaxed),
+                            rejected_notional_.load(std::memory_order_relaxed),
+                            rejected_position_.load(std::memory_order_relaxed), 0};
+        for (std::size_t i = 0; i < pool_.size(); ++i) s.dropped += pool_.outbox(i).dropped();
+        return s;
+    }
+
+    const ThreadActivity&   activity() const noexcept { return activity_; }
+    const AllocCounter&     allocations() const noexcept { return allocs_; }
+    const LatencyHistogram& tick_to_order() const noexcept { return tick_to_order_; }
+
+  private:
+    static void bump(std::atomic<std::uint64_t>& c) noexcept
+    {
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    OrderStatus check(const OrderIntent& o) noexcept
+    {
+        const RiskLimits& l = cfg_.limits;
+        if (o.instrument >= kMaxInstruments || !(o.qty > 0) || (l.max_order_qty > 0 && o.qty > l.max_order_qty))
+        {
+            bump(rejected_qty_);
+            return OrderStatus::RejectedQty;
+        }
+        if (l.max_order_notional > 0 && std::abs(o.price * o.qty) > l.max_order_notional)
+        {
+            bump(rejected_notional_);
+            return OrderStatus::RejectedNotional;
+        }
+        double&      pos   = positions_[o.instrument];
+        const double after = pos + (o.side == Side::Buy ? o.qty : -o.qty);
+        if (l.max_position > 0 && std::abs(after) > l.max_position)
+        {
+            bump(rejected_position_);
+            return OrderStatus::RejectedPosition;
+        }
+        pos = after;
+        return OrderStatus::Accepted;
+    }
+
+    void run()
+    {
+        pin_current_thread(cfg_.cpu);
+        std::array<OrderIntent, kDrainBatch> batch;
+        IdleStrategy idle(cfg_.wait, pool_.order_bell());
+        std::size_t  first = 0;
+        const auto   any_orders = [this] {
+            for (std::size_t i = 0; i < pool_.size(); ++i)
+                if (!pool_.outbox(i).empty()) return true;
+            return !running_.load(std::memory_order_relaxed);
+        };
+        const NoAllocScope no_alloc(allocs_);
+        while (running_.load(std::memory_order_relaxed))
+        {
+            bool found = false;
+            for (std::size_t k = 0; k < pool_.size(); ++k)
+            {
+                OrderOutbox&      outbox = pool_.outbox((first + k) % pool_.size());
+                const std::size_t n      = outbox.pop_n(batch);
+                if (n == 0) continue;
+                found = true;
+                activity_.mark_busy();
+                idle.reset();
+                for (const OrderIntent& o : std::span(batch).first(n))
+                {
+                    const OrderStatus status = check(o);
+                    if (status == OrderStatus::Accepted)
+                    {
+                        sink_.send(o);
+                        tick_to_order_.record(Clock::now() - o.tick_ts);
+                        bump(accepted_);
+                    }
+                    outbox.ack({o.strategy, status, o.id});
+                }
+            }
+            first = (first + 1) % pool_.size();
+            if (found) continue;
+
+            activity_.mark_idle();
+            idle.idle(any_orders);
+        }
+    }
+
+    ThreadPoolOfStrategies&    pool_;
+    OrderSink&                 sink_;
+    const OrderGatewayConfig   cfg_;
+    std::unique_ptr<double[]>  positions_; // net accepted qty per InstrumentId
+    ThreadActivity             activity_;
+    AllocCounter               allocs_;
+    LatencyHistogram           tick_to_order_;
+    std::atomic<std::uint64_t> accepted_{0};
+    std::atomic<std::uint64_t> rejected_qty_{0};
+    std::atomic<std::uint64_t> rejected_notional_{0};
+    std::atomic<std::uint64_t> rejected_position_{0};
+    std::atomic<bool>          running_{true};
+    std::thread                th_;
+};
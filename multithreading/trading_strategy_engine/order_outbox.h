@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "engine_types.h"
+#include "spsc_ring_buffer.h"
+#include "wait_strategy.h"
+
+// ---------- Per-worker order outbox -----------------------------------------
+
+/*
+ * SPSC ring from one strategy worker to the order gateway, plus one back for
+ * the gateway's OrderAcks. The worker makes
+ * its outbox current() for its thread, so a strategy publishes with
+ * Strategy::send_order() without knowing which worker it runs on; that keeps
+ * working across a rebalance.
+ *
+ * A full outbox rejects the order (counted in dropped()) rather than blocking
+ * the worker: a stale order is worse than none.
+ */
+class OrderOutbox
+{
+  public:
+    OrderOutbox(Doorbell& gateway_bell, Doorbell& worker_bell) noexcept: bell_(gateway_bell), worker_bell_(worker_bell)
+    {}
+
+    // The outbox of the calling worker thread; nullptr elsewhere.
+    static OrderOutbox*& current() noexcept
+    {
+        thread_local OrderOutbox* outbox = nullptr;
+        return outbox;
+    }
+
+    // ---- producer side (worker thread) ----
+
+    bool push(const OrderIntent& o) noexcept
+    {
+        if (!ring_.push(o))
+        {
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        bell_.ring();
+        return true;
+    }
+
+    std::size_t pop_acks(std::span<OrderAck> out) noexcept { return acks_.pop_n(out); }
+    bool        has_acks() const noexcept { return !acks_.empty(); }
+
+    // ---- consumer side (gateway thread) ----
+
+    std::size_t pop_n(std::span<OrderIntent> out) noexcept { return ring_.pop_n(out); }
+    bool        empty() const noexcept { return ring_.empty(); }
+
+    // Same drop rule as orders: a full ack ring means the worker is far behind.
+    void ack(const OrderAck& a) noexcept
+    {
+        if (!acks_.push(a))
+        {
+            acks_dropped_.store(acks_dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        worker_bell_.ring();
+    }
+
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    std::uint64_t acks_dropped() const noexcept { return acks_dropped_.load(std::memory_order_relaxed); }
+
+  private:
+    SpscRingBuffer<OrderIntent, 1 << 12> ring_;
+    SpscRingBuffer<OrderAck, 1 << 12>    acks_;
+    Doorbell&                            bell_;
+    Doorbell&                            worker_bell_;
+    std::atomic<std::uint64_t>           dropped_{0};
+    std::atomic<std::uint64_t>           acks_dropped_{0};
+};
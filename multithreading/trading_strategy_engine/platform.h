@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+// Destructive interference size on every x86-64 / ARMv8 part we run on.
+// (std::hardware_destructive_interference_size is ABI-unstable in GCC.)
+inline constexpr std::size_t kCacheLine = 64;
+
+// Spin-wait hint: lets the sibling hyper-thread run and avoids the memory-order
+// machine clear when the awaited line finally changes.
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
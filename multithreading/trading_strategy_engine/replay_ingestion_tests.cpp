@@ -0,0 +1,132 @@
+#include "strategy_engine.h"
+#include "tick_capture.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Standalone checks for ReplayIngestion on good and corrupted captures; exits
+ * non-zero on the first failure.
+ *   g++ -std=c++2b -O1 -g replay_ingestion_tests.cpp -o replay_ingestion_tests
+ */
+
+#define CHECK(cond)                                                                                                    \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #cond ") failed\n";                                 \
+            std::exit(1);                                                                                              \
+        }                                                                                                              \
+    } while (0)
+
+static const std::string kPath = "/tmp/replay_ingestion_tests.tick";
+
+// Writes a capture with one record per id in `ids`; finished and naming
+// `symbols`, or left unfinished (placeholder header) when there are none.
+static void write_capture(const std::vector<InstrumentId>& ids, const std::vector<std::string>& symbols)
+{
+    TickFileHeader h;
+    h.record_size    = sizeof(TickRecord);
+    if (!symbols.empty())
+    {
+        h.record_count   = ids.size();
+        h.symbols_offset = sizeof(TickFileHeader) + ids.size() * sizeof(TickRecord);
+        h.symbol_count   = static_cast<std::uint32_t>(symbols.size());
+    }
+
+    std::FILE* f = std::fopen(kPath.c_str(), "wb");
+    CHECK(f);
+    std::fwrite(&h, sizeof(h), 1, f);
+    std::int64_t ts = 0;
+    for (const InstrumentId id : ids)
+    {
+        const TickRecord r{++ts, id, 0, 100.0, 1.0};
+        std::fwrite(&r, sizeof(r), 1, f);
+    }
+    for (const std::string& name : symbols)
+    {
+        TickSymbol sym{};
+        std::memcpy(sym.name.data(), name.data(), std::min(name.size(), sym.name.size() - 1));
+        std::fwrite(&sym, sizeof(sym), 1, f);
+    }
+    CHECK(std::fclose(f) == 0);
+}
+
+struct Engine
+{
+    InstrumentStrategyRegistry registry;
+    MarketDataStore            store;
+    ThreadPoolOfStrategies     pool{1};
+    Dispatcher                 dispatcher{registry, store, pool};
+    SymbolTable                instruments;
+};
+
+static bool replay_rejected()
+{
+    Engine         e;
+    const TickFile file(kPath);
+    try
+    {
+        ReplayIngestion replay(e.dispatcher, file, e.instruments);
+        while (!replay.done()) std::this_thread::yield();
+        return false;
+    }
+    catch (const std::runtime_error&)
+    {
+        return e.instruments.size() <= kMaxInstruments;
+    }
+}
+
+// A well-formed capture replays every record.
+static void ValidCaptureReplays()
+{
+    write_capture({0, 1, 0}, {"IBM", "MSFT"});
+    Engine         e;
+    const TickFile file(kPath);
+    {
+        ReplayIngestion replay(e.dispatcher, file, e.instruments);
+        while (!replay.done()) std::this_thread::yield();
+        CHECK(replay.replayed() == 3);
+    }
+    CHECK(e.instruments.size() == 2);
+}
+
+// A record id that names no captured symbol rejects the file.
+static void IdBeyondSymbolTableRejected()
+{
+    write_capture({0, 2, 1}, {"IBM", "MSFT"});
+    CHECK(replay_rejected());
+}
+
+// A corrupt id near 2^32 is rejected before anything is sized from it.
+static void HugeIdRejected()
+{
+    write_capture({0, 0xfffffff0u}, {"IBM"});
+    CHECK(replay_rejected());
+}
+
+// Without a symbol table (unfinished capture) ids still must fit the engine.
+static void UnnamedIdBeyondEngineRejected()
+{
+    write_capture({0, static_cast<InstrumentId>(kMaxInstruments)}, {});
+    CHECK(replay_rejected());
+}
+
+int main()
+{
+    ValidCaptureReplays();
+    IdBeyondSymbolTableRejected();
+    HugeIdRejected();
+    UnnamedIdBeyondEngineRejected();
+    std::remove(kPath.c_str());
+    std::cout << "replay_ingestion_tests: all passed\n";
+    return 0;
+}
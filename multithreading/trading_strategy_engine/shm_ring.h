@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "platform.h"
+
+// ---------- Shared-memory SPSC ring -----------------------------------------
+
+/*
+ * Segment layout (one POSIX shm object, /dev/shm/<name>):
+ *
+ *   ShmRingHeader           magic, version, element size, capacity, and the
+ *                           pid attached on each side (0 = none)
+ *   head                    producer line
+ *   tail                    consumer line
+ *   slots[Capacity]
+ *
+ * The version is stored last by whichever side creates the segment, so an
+ * attacher that finds it non-zero sees a fully initialised header.
+ */
+struct ShmRingHeader
+{
+    static constexpr std::array<char, 8> kMagic{'S', 'H', 'M', 'R', 'I', 'N', 'G', '1'};
+    static constexpr std::uint32_t       kVersion = 1;
+
+    std::array<char, 8>        magic{};
+    std::atomic<std::uint32_t> version{0}; // 0 until the creator has filled in the rest
+    std::uint32_t              element_size{};
+    std::uint64_t              capacity{};
+    std::atomic<std::int32_t>  producer_pid{0};
+    std::atomic<std::int32_t>  consumer_pid{0};
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::int32_t>::is_always_lock_free,
+              "shared-memory atomics must be address-free");
+
+/*
+ * SpscRingBuffer across processes: the same free-running head / tail, the
+ * same cached opposite index kept in each side's own (process-local) handle,
+ * and the same single index publication per burst, so a push or pop costs
+ * what it does in-process. Elements are copied in and out with memcpy and
+ * must be trivially copyable: no pointers cross the process boundary.
+ * steady_clock stamps do, as CLOCK_MONOTONIC is system-wide.
+ *
+ * Either side may start first; the first one creates the segment. Each role
+ * is claimed by storing the process id in the header and released on
+ * destruction. A role held by a process that no longer exists (it crashed) is
+ * taken over, and the ring carries on from the published indices:
+ *  * a producer that died mid-push loses the unpublished element only;
+ *  * a consumer that died mid-burst gets its unacknowledged elements again.
+ * peer_alive() tells either side whether the other is attached and running.
+ * Liveness is by pid, so a recycled pid reads as alive until it exits.
+ *
+ * The segment outlives both sides until unlink() is called.
+ */
+template <typename T, std::size_t Capacity>
+class ShmRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "elements cross a process boundary and must be trivially copyable");
+
+  public:
+    enum class Role : std::uint8_t
+    {
+        Producer,
+        Consumer,
+    };
+
+    // name is a POSIX shm name, e.g. "/engine.md". Throws std::system_error
+    // when the segment cannot be opened or mapped, std::runtime_error when it
+    // holds a different ring or the role is taken by a live process.
+    ShmRing(const std::string& name, Role role, std::chrono::milliseconds attach_timeout = std::chrono::seconds(1))
+        : name_(name), role_(role)
+    {
+        bool      created = true;
+        const int fd      = open_or_create(created, attach_timeout);
+        void*     base    = ::mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "ShmRing: mmap " + name_);
+        seg_ = static_cast<Segment*>(base);
+
+        try
+        {
+            if (created)
+                initialise();
+            else
+                validate(attach_timeout);
+            claim();
+        }
+        catch (...)
+        {
+            ::munmap(seg_, sizeof(Segment));
+            throw;
+        }
+        head_cache_ = seg_->head.load(std::memory_order_acquire);
+        tail_cache_ = seg_->tail.load(std::memory_order_acquire);
+    }
+
+    ~ShmRing()
+    {
+        std::int32_t self = static_cast<std::int32_t>(::getpid());
+        own_pid().compare_exchange_strong(self, 0, std::memory_order_release);
+        ::munmap(seg_, sizeof(Segment));
+    }
+
+    ShmRing(const ShmRing&)            = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Removes the name; mapped handles keep working until they are destroyed.
+    static void unlink(const std::string& name) noexcept { ::shm_unlink(name.c_str()); }
+
+    // ---- producer side ----
+
+    bool push(const T& v) noexcept
+    {
+        const std::uint64_t head = seg_->head.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == Capacity)
+        {
+            tail_cache_ = seg_->tail.load(std::memory_order_acquire);
+            if (head - tail_cache_ == Capacity) return false; // ring full
+        }
+        std::memcpy(slot(head), &v, sizeof(T));
+        seg_->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Copies as many of items as fit, publishes them at once, returns the count.
+    std::size_t push_n(std::span<const T> items) noexcept
+    {
+        const std::uint64_t head = seg_->head.load(std::memory_order_relaxed);
+        std::size_t         n    = std::min<std::size_t>(items.size(), Capacity - (head - tail_cache_));
+        if (n < items.size())
+        {
+            tail_cache_ = seg_->tail.load(std::memory_order_acquire);
+            n           = std::min<std::size_t>(items.size(), Capacity - (head - tail_cache_));
+            if (n == 0) return 0;
+        }
+        for (std::size_t i = 0; i < n; ++i) std::memcpy(slot(head + i), &items[i], sizeof(T));
+        seg_->head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // ---- consumer side ----
+
+    bool pop(T& out) noexcept
+    {
+        const std::uint64_t tail = seg_->tail.load(std::memory_order_relaxed);
+        if (tail == head_cache_)
+        {
+            head_cache_ = seg_->head.load(std::memory_order_acquire);
+            if (tail == head_cache_) return false; // ring empty
+        }
+        std::memcpy(&out, slot(tail), sizeof(T));
+        seg_->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t pop_n(std::span<T> out) noexcept
+    {
+        const std::uint64_t tail = seg_->tail.load(std::memory_order_relaxed);
+        std::size_t         n    = std::min<std::size_t>(out.size(), head_cache_ - tail);
+        if (n < out.size())
+        {
+            head_cache_ = seg_->head.load(std::memory_order_acquire);
+            n           = std::min<std::size_t>(out.size(), head_cache_ - tail);
+            if (n == 0) return 0;
+        }
+        for (std::size_t i = 0; i < n; ++i) std::memcpy(&out[i], slot(tail + i), sizeof(T));
+        seg_->tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // ---- either side ----
+
+    // The other role is attached and its process still exists.
+    bool peer_alive() const noexcept
+    {
+        const auto& peer = role_ == Role::Producer ? seg_->header.consumer_pid : seg_->header.producer_pid;
+        return pid_alive(peer.load(std::memory_order_acquire));
+    }
+
+    std::size_t size() const noexcept
+    {
+        const std::uint64_t tail = seg_->tail.load(std::memory_order_acquire);
+        return static_cast<std::size_t>(std::min<std::uint64_t>(seg_->head.load(std::memory_order_acquire) - tail, Capacity));
+    }
+    bool                         empty() const noexcept { return size() == 0; }
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+    const std::string&           name() const noexcept { return name_; }
+
+  private:
+    struct Slot
+    {
+        alignas(T) std::byte bytes[sizeof(T)];
+    };
+
+    struct Segment
+    {
+        alignas(kCacheLine) ShmRingHeader header;
+        alignas(kCacheLine) std::atomic<std::uint64_t> head{0};
+        alignas(kCacheLine) std::atomic<std::uint64_t> tail{0};
+        alignas(kCacheLine) Slot slots[Capacity];
+    };
+
+    void* slot(std::uint64_t i) noexcept { return seg_->slots[i & (Capacity - 1)].bytes; }
+
+    std::atomic<std::int32_t>& own_pid() noexcept
+    {
+        return role_ == Role::Producer ? seg_->header.producer_pid : seg_->header.consumer_pid;
+    }
+
+    static bool pid_alive(std::int32_t pid) noexcept { return pid > 0 && (::kill(pid, 0) == 0 || errno == EPERM); }
+
+    // Exclusive create first, so exactly one side initialises the segment.
+    int open_or_create(bool& created, std::chrono::milliseconds timeout)
+    {
+        int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0)
+        {
+            if (::ftruncate(fd, sizeof(Segment)) != 0)
+            {
+                const int err = errno;
+                ::close(fd);
+                ::shm_unlink(name_.c_str());
+                throw std::system_error(err, std::generic_category(), "ShmRing: ftruncate " + name_);
+            }
+            created = true;
+            return fd;
+        }
+        if (errno != EEXIST) throw std::system_error(errno, std::generic_category(), "ShmRing: cannot create " + name_);
+
+        created = false;
+        fd      = ::shm_open(name_.c_str(), O_RDWR, 0600);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "ShmRing: cannot open " + name_);
+        // The creator may not have sized it yet.
+        const auto  deadline = std::chrono::steady_clock::now() + timeout;
+        struct stat st{};
+        while (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) < sizeof(Segment) &&
+               std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (static_cast<std::size_t>(st.st_size) != sizeof(Segment))
+        {
+            ::close(fd);
+            throw std::runtime_error("ShmRing: " + name_ + " has the wrong size for this ring");
+        }
+        return fd;
+    }
+
+    void initialise() noexcept
+    {
+        ShmRingHeader& h = seg_->header;
+        h.magic          = ShmRingHeader::kMagic;
+        h.element_size   = sizeof(T);
+        h.capacity       = Capacity;
+        h.version.store(ShmRingHeader::kVersion, std::memory_order_release);
+    }
+
+    void validate(std::chrono::milliseconds timeout) const
+    {
+        const ShmRingHeader& h        = seg_->header;
+        const auto           deadline = std::chrono::steady_clock::now() + timeout;
+        while (h.version.load(std::memory_order_acquire) == 0 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (h.magic != ShmRingHeader::kMagic || h.version.load(std::memory_order_acquire) != ShmRingHeader::kVersion ||
+            h.element_size != sizeof(T) || h.capacity != Capacity)
+            throw std::runtime_error("ShmRing: " + name_ + " is not a v1 ring of this element type and capacity");
+    }
+
+    void claim()
+    {
+        const auto                 self = static_cast<std::int32_t>(::getpid());
+        std::atomic<std::int32_t>& slot = own_pid();
+        std::int32_t               cur  = slot.load(std::memory_order_acquire);
+        do
+        {
+            if (pid_alive(cur))
+                throw std::runtime_error("ShmRing: " + name_ + " already has a live " +
+                                         (role_ == Role::Producer ? "producer" : "consumer"));
+        } while (!slot.compare_exchange_weak(cur, self, std::memory_order_acq_rel));
+    }
+
+    const std::string name_;
+    const Role        role_;
+    Segment*          seg_{nullptr};
+    std::uint64_t     head_cache_{0}; // consumer's copy of head
+    std::uint64_t     tail_cache_{0}; // producer's copy of tail
+};
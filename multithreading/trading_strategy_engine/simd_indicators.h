@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "platform.h"
+
+// ---------- SIMD indicators over a structure-of-arrays universe ------------
+
+enum class SimdLevel : unsigned char
+{
+    Scalar,
+    Avx2,   // + FMA
+    Avx512, // AVX-512F
+};
+
+inline const char* to_string(SimdLevel l) noexcept
+{
+    return l == SimdLevel::Avx512 ? "avx512" : l == SimdLevel::Avx2 ? "avx2" : "scalar";
+}
+
+// Best level this CPU runs, checked once at runtime.
+inline SimdLevel detect_simd_level() noexcept
+{
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::Avx2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+struct IndicatorParams
+{
+    double ema_alpha{0.1};   // weight of the newest price in EMA / variance
+    double vwap_decay{0.05}; // weight lost per snapshot by older price * volume
+};
+
+/*
+ * Per-instrument indicators for a whole universe, one column per indicator
+ * (index = InstrumentId), updated a snapshot at a time:
+ *
+ *   ema      += a * (p - ema)
+ *   variance  = (1 - a) * (variance + a * (p - ema_prev)^2)   exponentially weighted
+ *   vwap      = sum(p * v) / sum(v), both sums decayed by (1 - vwap_decay)
+ *   zscore    = (p - ema) / sqrt(variance), 0 while variance is 0
+ *
+ * Every update is element-wise with no per-instrument history, so a snapshot
+ * is one streaming pass over contiguous columns, 4 (AVX2) or 8 (AVX-512)
+ * instruments per instruction. The kernel is picked at construction from
+ * detect_simd_level(), capped by the caller; the scalar kernel handles the
+ * tail and CPUs without AVX2. Columns are cache-line aligned.
+ *
+ * Owned by one thread: update() and the column reads must not race.
+ */
+class IndicatorEngine
+{
+  public:
+    explicit IndicatorEngine(std::size_t instruments, IndicatorParams params = {},
+                             SimdLevel max_level = SimdLevel::Avx512)
+        : n_(instruments), params_(params), level_(std::min(detect_simd_level(), max_level)),
+          ema_(alloc(n_)), var_(alloc(n_)), pv_(alloc(n_)), vv_(alloc(n_)), vwap_(alloc(n_)), z_(alloc(n_))
+    {}
+
+    // price and volume hold one value per instrument; volume 0 = no trade
+    // since the last snapshot.
+    void update(std::span<const double> price, std::span<const double> volume) noexcept
+    {
+        assert(price.size() == n_ && volume.size() == n_);
+        const Columns c{price.data(), volume.data(), ema_.get(), var_.get(), pv_.get(), vv_.get(), vwap_.get(), z_.get()};
+        if (!primed_)
+        {
+            prime(c, n_);
+            primed_ = true;
+            return;
+        }
+        std::size_t done = 0;
+#if defined(__x86_64__)
+        if (level_ == SimdLevel::Avx512)
+            done = update_avx512(c, n_, params_);
+        else if (level_ == SimdLevel::Avx2)
+            done = update_avx2(c, n_, params_);
+#endif
+        update_scalar(c, done, n_, params_);
+    }
+
+    std::span<const double> ema() const noexcept { return {ema_.get(), n_}; }
+    std::span<const double> variance() const noexcept { return {var_.get(), n_}; }
+    std::span<const double> vwap() const noexcept { return {vwap_.get(), n_}; }
+    std::span<const double> zscore() const noexcept { return {z_.get(), n_}; }
+
+    std::size_t size() const noexcept { return n_; }
+    SimdLevel   level() const noexcept { return level_; }
+
+  private:
+    struct AlignedFree
+    {
+        void operator()(double* p) const noexcept { ::operator delete[](p, std::align_val_t{kCacheLine}); }
+    };
+    using Column = std::unique_ptr<double[], AlignedFree>;
+
+    static Column alloc(std::size_t n)
+    {
+        const std::size_t padded = (n * sizeof(double) + kCacheLine - 1) / kCacheLine * kCacheLine;
+        auto*             p      = static_cast<double*>(::operator new[](padded, std::align_val_t{kCacheLine}));
+        for (std::size_t i = 0; i < padded / sizeof(double); ++i) p[i] = 0.0;
+        return Column(p);
+    }
+
+    struct Columns
+    {
+        const double* price;
+        const double* volume;
+        double*       ema;
+        double*       var;
+        double*       pv;
+        double*       vv;
+        double*       vwap;
+        double*       z;
+    };
+
+    static void prime(const Columns& c, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            c.ema[i]  = c.price[i];
+            c.var[i]  = 0.0;
+            c.pv[i]   = c.price[i] * c.volume[i];
+            c.vv[i]   = c.volume[i];
+            c.vwap[i] = c.price[i];
+            c.z[i]    = 0.0;
+        }
+    }
+
+    static void update_scalar(const Columns& c, std::size_t from, std::size_t n, const IndicatorParams& k) noexcept
+    {
+        const double a = k.ema_alpha, keep = 1.0 - k.vwap_decay;
+        for (std::size_t i = from; i < n; ++i)
+        {
+            const double p = c.price[i], v = c.volume[i];
+            const double d = p - c.ema[i];
+            c.ema[i] += a * d;
+            c.var[i]  = (1.0 - a) * (c.var[i] + a * d * d);
+            c.pv[i]   = c.pv[i] * keep + p * v;
+            c.vv[i]   = c.vv[i] * keep + v;
+            c.vwap[i] = c.vv[i] > 0.0 ? c.pv[i] / c.vv[i] : p;
+            const double sd = std::sqrt(c.var[i]);
+            c.z[i]    = sd > 0.0 ? (p - c.ema[i]) / sd : 0.0;
+        }
+    }
+
+#if defined(__x86_64__)
+    // Each returns how many leading instruments it covered; the scalar kernel
+    // does the rest.
+    __attribute__((target("avx2,fma"))) static std::size_t update_avx2(const Columns& c, std::size_t n,
+                                                                     const IndicatorParams& k) noexcept
+    {
+        const __m256d a    = _mm256_set1_pd(k.ema_alpha);
+        const __m256d ia   = _mm256_set1_pd(1.0 - k.ema_alpha);
+        const __m256d keep = _mm256_set1_pd(1.0 - k.vwap_decay);
+        const __m256d zero = _mm256_setzero_pd();
+        std::size_t   i    = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d p   = _mm256_loadu_pd(c.price + i);
+            const __m256d v   = _mm256_loadu_pd(c.volume + i);
+            __m256d       ema = _mm256_load_pd(c.ema + i);
+            const __m256d d   = _mm256_sub_pd(p, ema);
+            ema               = _mm256_fmadd_pd(a, d, ema);
+            const __m256d var = _mm256_mul_pd(ia, _mm256_fmadd_pd(_mm256_mul_pd(a, d), d, _mm256_load_pd(c.var + i)));
+            const __m256d pv  = _mm256_fmadd_pd(_mm256_load_pd(c.pv + i), keep, _mm256_mul_pd(p, v));
+            const __m256d vv  = _mm256_fmadd_pd(_mm256_load_pd(c.vv + i), keep, v);
+            const __m256d vwap =
+                _mm256_blendv_pd(p, _mm256_div_pd(pv, vv), _mm256_cmp_pd(vv, zero, _CMP_GT_OQ));
+            const __m256d sd = _mm256_sqrt_pd(var);
+            const __m256d z  = _mm256_and_pd(_mm256_div_pd(_mm256_sub_pd(p, ema), sd), _mm256_cmp_pd(sd, zero, _CMP_GT_OQ));
+            _mm256_store_pd(c.ema + i, ema);
+            _mm256_store_pd(c.var + i, var);
+            _mm256_store_pd(c.pv + i, pv);
+            _mm256_store_pd(c.vv + i, vv);
+            _mm256_store_pd(c.vwap + i, vwap);
+            _mm256_store_pd(c.z + i, z);
+        }
+        return i;
+    }
+
+    __attribute__((target("avx512f"))) static std::size_t update_avx512(const Columns& c, std::size_t n,
+                                                                      const IndicatorParams& k) noexcept
+    {
+        const __m512d a    = _mm512_set1_pd(k.ema_alpha);
+        const __m512d ia   = _mm512_set1_pd(1.0 - k.ema_alpha);
+        const __m512d keep = _mm512_set1_pd(1.0 - k.vwap_decay);
+        const __m512d zero = _mm512_setzero_pd();
+        std::size_t   i    = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d p   = _mm512_loadu_pd(c.price + i);
+            const __m512d v   = _mm512_loadu_pd(c.volume + i);
+            __m512d       ema = _mm512_load_pd(c.ema + i);
+            const __m512d d   = _mm512_sub_pd(p, ema);
+            ema               = _mm512_fmadd_pd(a, d, ema);
+            const __m512d var = _mm512_mul_pd(ia, _mm512_fmadd_pd(_mm512_mul_pd(a, d), d, _mm512_load_pd(c.var + i)));
+            const __m512d pv  = _mm512_fmadd_pd(_mm512_load_pd(c.pv + i), keep, _mm512_mul_pd(p, v));
+            const __m512d vv  = _mm512_fmadd_pd(_mm512_load_pd(c.vv + i), keep, v);
+            const __m512d vwap = _mm512_mask_div_pd(p, _mm512_cmp_pd_mask(vv, zero, _CMP_GT_OQ), pv, vv);
+            // All lanes; the explicit pass-through avoids _mm512_sqrt_pd's undefined one.
+            const __m512d sd   = _mm512_mask_sqrt_pd(zero, 0xFF, var);
+            const __m512d z    = _mm512_maskz_div_pd(_mm512_cmp_pd_mask(sd, zero, _CMP_GT_OQ), _mm512_sub_pd(p, ema), sd);
+            _mm512_store_pd(c.ema + i, ema);
+            _mm512_store_pd(c.var + i, var);
+            _mm512_store_pd(c.pv + i, pv);
+            _mm512_store_pd(c.vv + i, vv);
+            _mm512_store_pd(c.vwap + i, vwap);
+            _mm512_store_pd(c.z + i, z);
+        }
+        return i;
+    }
+#endif
+
+    const std::size_t     n_;
+    const IndicatorParams params_;
+    const SimdLevel       level_;
+    bool                  primed_{false};
+    Column                ema_, var_, pv_, vv_, vwap_, z_;
+};
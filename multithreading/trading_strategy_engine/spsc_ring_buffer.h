@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "platform.h"
+
+// ---------- 1. Lock‑free single‑producer / single‑consumer ring buffer -----
+
+/*
+ * head_ / tail_ are free-running counters (slot = counter & mask_), so all
+ * CapacityPow2 slots are usable and size() is a plain subtraction.
+ *
+ * Cache behaviour:
+ *  * producer fields (head_, tail_cache_) and consumer fields (tail_,
+ *    head_cache_) live on separate lines, away from the slots;
+ *  * each side keeps a private copy of the other side's index and only
+ *    re-reads the shared one when the copy says full / empty, so in steady
+ *    state a push or pop touches no line owned by the other core;
+ *  * push_n / pop_n move a whole burst with a single index publication.
+ *
+ * Slots are raw storage: elements are constructed in place by emplace() and
+ * destroyed when popped.
+ */
+template <typename T, std::size_t CapacityPow2>
+class SpscRingBuffer
+{
+    static_assert(CapacityPow2 > 0 && (CapacityPow2 & (CapacityPow2 - 1)) == 0,
+                  "Capacity must be power of two");
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>,
+                  "elements are moved on the hot path and must not throw");
+
+  public:
+    SpscRingBuffer() = default;
+    SpscRingBuffer(const SpscRingBuffer&)            = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    ~SpscRingBuffer()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            for (std::size_t i = tail_.load(std::memory_order_relaxed); i != head; ++i)
+                std::destroy_at(slot(i));
+        }
+    }
+
+    // ---- producer side ----
+
+    template <typename... Args>
+    bool emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == CapacityPow2)
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ == CapacityPow2)
+                return false;             // queue full
+        }
+        std::construct_at(slot(head), std::forward<Args>(args)...);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& v) noexcept(std::is_nothrow_copy_constructible_v<T>) { return emplace(v); }
+    bool push(T&& v) noexcept { return emplace(std::move(v)); }
+
+    // Copies as many of items as fit, publishes them at once, returns the count.
+    std::size_t push_n(std::span<const T> items) noexcept(std::is_nothrow_copy_constructible_v<T>)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t       n    = std::min(items.size(), CapacityPow2 - (head - tail_cache_));
+        if (n < items.size())
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            n           = std::min(items.size(), CapacityPow2 - (head - tail_cache_));
+            if (n == 0) return 0;
+        }
+        for (std::size_t i = 0; i < n; ++i)
+            std::construct_at(slot(head + i), items[i]);
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // ---- consumer side ----
+
+    bool pop(T& out) noexcept
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_)
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_)
+                return false;             // queue empty
+        }
+        T* p = slot(tail);
+        out  = std::move(*p);
+        std::destroy_at(p);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Moves up to out.size() elements into out, frees their slots at once,
+    // returns the count.
+    std::size_t pop_n(std::span<T> out) noexcept
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t       n    = std::min(out.size(), head_cache_ - tail);
+        if (n < out.size())
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            n           = std::min(out.size(), head_cache_ - tail);
+            if (n == 0) return 0;
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            T* p   = slot(tail + i);
+            out[i] = std::move(*p);
+            std::destroy_at(p);
+        }
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Writes every slot page so it is allocated on the NUMA node of the calling
+    // thread (Linux first-touch). Call on the consumer thread, while the ring
+    // is still empty and before any producer uses it.
+    void prefault() noexcept { std::memset(static_cast<void*>(buffer_), 0, sizeof(buffer_)); }
+
+    // ---- either side (approximate while the other side is running) ----
+
+    std::size_t size() const noexcept
+    {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_acquire) - tail;
+    }
+    bool empty() const noexcept { return size() == 0; }
+    static constexpr std::size_t capacity() noexcept { return CapacityPow2; }
+
+  private:
+    static constexpr std::size_t mask_ = CapacityPow2 - 1;
+
+    struct Slot
+    {
+        alignas(T) std::byte bytes[sizeof(T)];
+    };
+
+    T* slot(std::size_t i) noexcept { return std::launder(reinterpret_cast<T*>(buffer_[i & mask_].bytes)); }
+
+    // producer line
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+    std::size_t                                  tail_cache_{0};
+    // consumer line
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+    std::size_t                                  head_cache_{0};
+
+    alignas(kCacheLine) Slot buffer_[CapacityPow2];
+};
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "arena.h"
+#include "engine_types.h"
+#include "order_outbox.h"
+#include "timing_wheel.h"
+
+// ---------- 5. Strategy interface -----------------------------------------
+
+/*
+ * Workers call the batch overload once per run of consecutive actions for the
+ * same strategy, i.e. one indirect call per run instead of one per tick. The
+ * default forwards tick by tick; strategies that can do better (vectorize over
+ * prices, amortize state loads) override it, or derive from StaticStrategy.
+ */
+class Strategy
+{
+  public:
+    Strategy(StrategyId id, std::string name): id_(id), name_(std::move(name)) {}
+    virtual ~Strategy() = default;
+    StrategyId id() const noexcept { return id_; }
+    const std::string& name() const noexcept { return name_; }
+    virtual void on_market_data(const MarketData&) = 0;
+
+    // Every action in batch is a Tick for this strategy, in arrival order.
+    virtual void on_market_data(std::span<const MarketDataAction> batch)
+    {
+        for (const MarketDataAction& a : batch) on_market_data(a.data);
+    }
+
+    // The gateway's verdict on an order from send_order(), delivered by the
+    // worker that sent it. Acks that reach the old worker after a rebalance()
+    // are dropped there, so only move strategies with no orders in flight.
+    virtual void on_order_ack(const OrderAck&) {}
+
+    // A timer from set_timer() / set_periodic() is due. Runs on the worker
+    // thread between bursts, never concurrently with on_market_data. Timers
+    // live on the worker that armed them; see on_handoff().
+    virtual void on_timer(TimerId, std::uint64_t /*cookie*/) {}
+
+    // rebalance() is moving this strategy to another worker. Runs on the old
+    // worker after its last tick there: cancel timers and free anything taken
+    // from that worker, and re-arm from the new worker's first call.
+    virtual void on_handoff() {}
+
+  protected:
+    using Clock = std::chrono::steady_clock;
+
+    // From a worker thread only (kNoTimer elsewhere, or when the worker's
+    // wheel is full). cookie comes back in on_timer.
+    TimerId set_timer(Clock::time_point deadline, std::uint64_t cookie = 0) noexcept
+    {
+        TimingWheel* w = TimingWheel::current();
+        return w ? w->schedule_at(deadline, &Strategy::fire, this, cookie) : kNoTimer;
+    }
+    // Every period until cancelled; WallClock aligns the fires to multiples of
+    // period on the system clock (whole seconds for 1s).
+    TimerId set_periodic(Clock::duration period, std::uint64_t cookie = 0, TimerAlign align = TimerAlign::None) noexcept
+    {
+        TimingWheel* w = TimingWheel::current();
+        return w ? w->schedule_every(period, &Strategy::fire, this, cookie, align) : kNoTimer;
+    }
+    bool cancel_timer(TimerId id) noexcept
+    {
+        TimingWheel* w = TimingWheel::current();
+        return w && w->cancel(id);
+    }
+
+    // From inside on_market_data: hand an order to the gateway. trigger is the
+    // tick that caused it, for tick-to-order latency. Returns the order id that
+    // its OrderAck will carry; 0 if the outbox is full or the caller is not on
+    // a worker thread.
+    std::uint64_t send_order(const MarketData& trigger, InstrumentId inst, Side side, double price, double qty) noexcept
+    {
+        OrderOutbox* out = OrderOutbox::current();
+        if (!out) return 0;
+        const std::uint64_t id = ++next_order_id_;
+        return out->push({id_, inst, side, price, qty, trigger.ts, id}) ? id : 0;
+    }
+
+  private:
+    static void fire(void* self, TimerId id, std::uint64_t cookie) { static_cast<Strategy*>(self)->on_timer(id, cookie); }
+
+    StrategyId    id_;
+    std::string   name_;
+    std::uint64_t next_order_id_{0};
+};
+
+/*
+ * CRTP base: Derived provides on_tick(const MarketData&) and may provide
+ * on_batch(std::span<const MarketDataAction>). Both virtual entry points are
+ * final and call into Derived statically, so the per-tick loop of a batch
+ * inlines on_tick and the only indirect call left is the one per batch.
+ */
+template <typename Derived>
+class StaticStrategy : public Strategy
+{
+  public:
+    using Strategy::Strategy;
+
+    void on_market_data(const MarketData& md) final { derived().on_tick(md); }
+    void on_market_data(std::span<const MarketDataAction> batch) final { derived().on_batch(batch); }
+
+    // Default batch: a statically dispatched loop over on_tick.
+    void on_batch(std::span<const MarketDataAction> batch)
+    {
+        for (const MarketDataAction& a : batch) derived().on_tick(a.data);
+    }
+
+  private:
+    Derived& derived() noexcept { return static_cast<Derived&>(*this); }
+};
+
+// Example dummy strategy
+class PrintStrategy final : public StaticStrategy<PrintStrategy>
+{
+  public:
+    using StaticStrategy::StaticStrategy;
+    void on_tick(const MarketData& md)
+    {
+        std::cout << "[Strat " << name() << "] price=" << md.price << '\n';
+    }
+};
+
+// Example order-emitting strategy: buys below lo, sells above hi.
+class ThresholdStrategy final : public StaticStrategy<ThresholdStrategy>
+{
+  public:
+    ThresholdStrategy(StrategyId id, std::string name, InstrumentId inst, double lo, double hi, double qty = 1.0)
+        : StaticStrategy(id, std::move(name)), inst_(inst), lo_(lo), hi_(hi), qty_(qty)
+    {}
+
+    void on_tick(const MarketData& md)
+    {
+        if (md.price < lo_)
+            send_order(md, inst_, Side::Buy, md.price, qty_);
+        else if (md.price > hi_)
+            send_order(md, inst_, Side::Sell, md.price, qty_);
+    }
+
+  private:
+    InstrumentId inst_;
+    double       lo_, hi_, qty_;
+};
+
+// Example scratch user: the median price of each burst, sorted in the worker's
+// per-burst Arena rather than on the heap. Without room it keeps the last price.
+class BurstMedianStrategy final : public StaticStrategy<BurstMedianStrategy>
+{
+  public:
+    using StaticStrategy::StaticStrategy;
+
+    void on_tick(const MarketData& md) { median_.store(md.price, std::memory_order_relaxed); }
+    void on_batch(std::span<const MarketDataAction> batch)
+    {
+        Arena* scratch = Arena::current();
+        auto*  prices  = scratch ? static_cast<double*>(scratch->allocate(batch.size() * sizeof(double), alignof(double)))
+                                 : nullptr;
+        if (!prices)
+        {
+            on_tick(batch.back().data);
+            return;
+        }
+        for (std::size_t i = 0; i < batch.size(); ++i) prices[i] = batch[i].data.price;
+        std::nth_element(prices, prices + batch.size() / 2, prices + batch.size());
+        median_.store(prices[batch.size() / 2], std::memory_order_relaxed);
+    }
+
+    // Any thread.
+    double median() const noexcept { return median_.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<double> median_{0};
+};
+
+// Example timer-driven strategy: accumulates VWAP from ticks and publishes it
+// on a periodic timer aligned to the wall clock, whether or not ticks arrive.
+class PeriodicVwapStrategy final : public StaticStrategy<PeriodicVwapStrategy>
+{
+  public:
+    PeriodicVwapStrategy(StrategyId id, std::string name, Clock::duration period)
+        : StaticStrategy(id, std::move(name)), period_(period)
+    {}
+
+    void on_tick(const MarketData& md)
+    {
+        // Armed from the worker thread on the first tick: set_periodic needs its wheel.
+        if (timer_ == kNoTimer) timer_ = set_periodic(period_, 0, TimerAlign::WallClock);
+        pv_ += md.price * md.size;
+        v_ += md.size;
+    }
+    void on_timer(TimerId, std::uint64_t) override
+    {
+        if (v_ > 0) vwap_.store(pv_ / v_, std::memory_order_relaxed);
+        pv_ = v_ = 0;
+        publishes_.store(publishes_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    void on_handoff() override { cancel_timer(std::exchange(timer_, kNoTimer)); } // re-armed by the next tick
+
+    // Any thread.
+    double        vwap() const noexcept { return vwap_.load(std::memory_order_relaxed); }
+    std::uint64_t publishes() const noexcept { return publishes_.load(std::memory_order_relaxed); }
+
+  private:
+    Clock::duration            period_;
+    TimerId                    timer_{kNoTimer};
+    double                     pv_{0}, v_{0};
+    std::atomic<double>        vwap_{0};
+    std::atomic<std::uint64_t> publishes_{0};
+};
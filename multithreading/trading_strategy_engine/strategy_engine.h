@@ -0,0 +1,1006 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc_guard.h"
+#include "arena.h"
+#include "conflating_mailbox.h"
+#include "engine_queue.h"
+#include "engine_types.h"
+#include "instrument_strategy_registry.h"
+#include "latency_histogram.h"
+#include "market_data_store.h"
+#include "metrics.h"
+#include "order_book.h"
+#include "order_outbox.h"
+#include "shm_ring.h"
+#include "strategy.h"
+#include "thread_placement.h"
+#include "tick_capture.h"
+#include "timing_wheel.h"
+#include "wait_strategy.h"
+
+// ---------- 6. Strategy worker & pool --------------------------------------
+
+// Shared between the pool and its workers, indexed by StrategyId.
+struct StrategySlot
+{
+    std::atomic<Strategy*> strategy{nullptr};
+    std::atomic<bool>      handed_off{false}; // old owner drained up to the Handoff marker
+};
+using StrategyTable = std::array<StrategySlot, kMaxStrategies>;
+
+struct WorkerConfig
+{
+    WaitConfig     wait{};
+    OverflowConfig overflow{};
+    bool           conflate{false}; // ticks go through a ConflatingMailbox instead of the queue
+    int            cpu{-1};         // pin target, see EnginePlacement
+    std::size_t    scratch_bytes{1 << 20}; // per-burst Arena for strategies, see Arena::current()
+    std::size_t    frame_bytes{256 << 10}; // coroutine frames of CoStrategy, see FrameArena
+    std::size_t    timers{4096};           // strategy timers armed at once, see Strategy::set_timer
+};
+
+// Written by the worker thread only, on lines of their own; see Counter.
+struct alignas(kCacheLine) WorkerCounters
+{
+    Counter ticks;  // delivered to strategies
+    Counter bursts; // non-empty queue / mailbox drains
+    Counter acks;
+    Counter stray_acks; // for strategies since moved to another worker; dropped
+    Counter timers;     // fired
+};
+
+class StrategyWorker
+{
+    using Queue = EngineQueue<MarketDataAction, 1 << 12>; // 4096
+
+  public:
+    StrategyWorker(StrategyTable& strategies, const WorkerConfig& cfg, Doorbell& order_bell)
+        : strategies_(strategies), wait_(cfg.wait), cpu_(cfg.cpu), bell_(cfg.wait.policy == WaitPolicy::SpinPark),
+          q_(cfg.overflow), mailbox_(cfg.conflate ? std::make_unique<ConflatingMailbox>() : nullptr),
+          outbox_(order_bell, bell_), scratch_(cfg.scratch_bytes), frames_(cfg.frame_bytes), timers_(cfg.timers),
+          th_([this] { run(); })
+    {
+        ready_.wait(false, std::memory_order_acquire);
+    }
+
+    ~StrategyWorker() { stop(); }
+
+    // Joins the thread; the worker calls no strategy afterwards.
+    void stop()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        bell_.wake();
+        if (th_.joinable()) th_.join();
+    }
+
+    // Producer side (dispatcher thread).
+    bool enqueue(const MarketDataAction& a)
+    {
+        if (mailbox_ && a.kind == ActionKind::Tick)
+            mailbox_->post(a);
+        else if (!q_.offer(a))
+            return false;
+        bell_.ring();
+        return true;
+    }
+    // Markers and handoff replays must not be dropped: wait for room instead.
+    void enqueue_blocking(const MarketDataAction& a)
+    {
+        while (!q_.try_put(a))
+        {
+            bell_.ring();
+            std::this_thread::yield();
+        }
+        bell_.ring();
+    }
+    void flush()
+    {
+        if (!q_.has_held()) return;
+        q_.flush();
+        bell_.ring();
+    }
+    bool has_held() const noexcept { return q_.has_held(); }
+
+    const ThreadActivity& activity() const noexcept { return activity_; }
+    QueueStats            queue_stats() const noexcept { return q_.stats(); }
+    ConflatingMailbox::Stats mailbox_stats() const noexcept { return mailbox_ ? mailbox_->stats() : ConflatingMailbox::Stats{}; }
+    OrderOutbox&          outbox() noexcept { return outbox_; }
+    // Allocations on this thread after warm-up; see NoAllocScope.
+    const AllocCounter&   allocations() const noexcept { return allocs_; }
+    const WorkerCounters& counters() const noexcept { return counters_; }
+
+    // dispatcher -> worker: dispatch stamp to the start of the worker's burst
+    const LatencyHistogram& dispatch_to_worker() const noexcept { return dispatch_to_worker_; }
+    // worker -> return: start of the burst to on_market_data() returning
+    const LatencyHistogram& worker_to_return() const noexcept { return worker_to_return_; }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    // One call for a run of ticks to the same strategy.
+    void deliver(StrategyId sid, std::span<const MarketDataAction> run, Clock::time_point received)
+    {
+        if (Strategy* s = strategies_[sid].strategy.load(std::memory_order_acquire))
+        {
+            moved_away_[sid] = false; // ticks again: rebalanced back here
+            s->on_market_data(run);
+            worker_to_return_.record(Clock::now() - received, run.size());
+            counters_.ticks.add(run.size());
+        }
+    }
+
+    // Stable insertion sort by strategy, so each strategy's ticks form one run
+    // in their original order. Bursts are at most kDrainBatch long and often
+    // already grouped, and nothing is allocated. A Handoff marker keeps its
+    // place after the ticks of its strategy.
+    static void group_by_strategy(std::span<MarketDataAction> batch) noexcept
+    {
+        for (std::size_t i = 1; i < batch.size(); ++i)
+        {
+            if (batch[i - 1].strategy <= batch[i].strategy) continue;
+            const MarketDataAction v = batch[i];
+            std::size_t            j = i;
+            for (; j > 0 && batch[j - 1].strategy > v.strategy; --j) batch[j] = batch[j - 1];
+            batch[j] = v;
+        }
+    }
+
+    std::size_t drain_mailbox(std::size_t max_entries = kDrainBatch)
+    {
+        const Clock::time_point received = Clock::now();
+        return mailbox_->drain(
+            [this, received](InstrumentId inst, StrategyId sid, const MarketData& md) {
+                const MarketDataAction a{inst, sid, ActionKind::Tick, md, {}};
+                deliver(sid, std::span(&a, 1), received);
+            },
+            max_entries);
+    }
+
+    // Gateway verdicts on orders sent from this worker. A strategy that has
+    // been rebalanced away now runs on another thread, so its late acks are
+    // dropped rather than delivered here.
+    std::size_t drain_acks()
+    {
+        std::array<OrderAck, kDrainBatch> acks;
+        const std::size_t n = outbox_.pop_acks(acks);
+        for (const OrderAck& a : std::span(acks).first(n))
+        {
+            if (moved_away_[a.strategy])
+                counters_.stray_acks.add();
+            else if (Strategy* s = strategies_[a.strategy].strategy.load(std::memory_order_acquire))
+                s->on_order_ack(a);
+        }
+        if (n) counters_.acks.add(n);
+        return n;
+    }
+
+    // Timers due by now; the clock is read only while some are armed.
+    std::size_t fire_timers()
+    {
+        if (timers_.size() == 0) return 0;
+        const std::size_t n = timers_.advance(Clock::now());
+        if (n)
+        {
+            scratch_.reset();
+            counters_.timers.add(n);
+        }
+        return n;
+    }
+
+    // Longest the worker may park: until the next timer.
+    Clock::duration max_sleep() const noexcept
+    {
+        if (timers_.size() == 0) return Clock::duration::max();
+        return std::max(timers_.next_check() - Clock::now(), Clock::duration::zero());
+    }
+
+    void run()
+    {
+        // Pin first, then touch the rings from here so their pages land on this
+        // core's node. The constructor waits, so no producer has used them yet.
+        pin_current_thread(cpu_);
+        q_.prefault();
+        if (mailbox_) mailbox_->prefault();
+        scratch_.prefault();
+        frames_.prefault();
+        OrderOutbox::current() = &outbox_; // strategies' send_order() lands here
+        Arena::current()       = &scratch_;
+        FrameArena::current()  = &frames_;
+        TimingWheel::current() = &timers_;
+        ready_.store(true, std::memory_order_release);
+        ready_.notify_one();
+
+        std::array<MarketDataAction, kDrainBatch> batch;
+        IdleStrategy idle(wait_, bell_);
+        const NoAllocScope no_alloc(allocs_); // warm-up is over
+        while (running_.load(std::memory_order_relaxed))
+        {
+            // Between drains: nothing runs a strategy concurrently with its ticks.
+            if (fire_timers() + drain_acks())
+            {
+                activity_.mark_busy();
+                idle.reset();
+            }
+            while (const std::size_t n = q_.pop_n(batch))
+            {
+                activity_.mark_busy();
+                idle.reset();
+                counters_.bursts.add();
+                // One clock read per burst for the hand-off latency.
+                const Clock::time_point received = Clock::now();
+                const std::span<MarketDataAction> burst = std::span(batch).first(n);
+                group_by_strategy(burst);
+                for (std::size_t i = 0; i < n;)
+                {
+                    const MarketDataAction& a = burst[i];
+                    if (a.kind == ActionKind::Handoff)
+                    {
+                        // Ticks posted before the marker are all in the ready list by now.
+                        if (mailbox_) drain_mailbox(mailbox_->ready());
+                        // Last call here: the strategy lets go of this worker's timers and arena.
+                        if (Strategy* s = strategies_[a.strategy].strategy.load(std::memory_order_acquire))
+                            s->on_handoff();
+                        moved_away_[a.strategy] = true;
+                        // Every earlier tick for this strategy has been processed here.
+                        strategies_[a.strategy].handed_off.store(true, std::memory_order_release);
+                        ++i;
+                        continue;
+                    }
+                    std::size_t end = i + 1;
+                    while (end < n && burst[end].strategy == a.strategy && burst[end].kind == ActionKind::Tick) ++end;
+                    for (const MarketDataAction& t : burst.subspan(i, end - i))
+                        dispatch_to_worker_.record(received - t.dispatched);
+                    deliver(a.strategy, burst.subspan(i, end - i), received);
+                    i = end;
+                }
+                scratch_.reset();
+            }
+            if (mailbox_ && drain_mailbox())
+            {
+                counters_.bursts.add();
+                scratch_.reset();
+                activity_.mark_busy();
+                idle.reset();
+                continue;
+            }
+
+            activity_.mark_idle();
+            idle.idle(
+                [this] {
+                    return !q_.empty() || (mailbox_ && !mailbox_->empty()) || outbox_.has_acks() ||
+                           !running_.load(std::memory_order_relaxed);
+                },
+                max_sleep());
+        }
+    }
+
+    StrategyTable&    strategies_;
+    const WaitConfig  wait_;
+    const int         cpu_;
+    Doorbell          bell_;
+    ThreadActivity    activity_;
+    std::atomic<bool> running_{true};
+    std::atomic<bool> ready_{false};
+    Queue             q_;
+    std::unique_ptr<ConflatingMailbox> mailbox_;
+    OrderOutbox       outbox_;
+    Arena             scratch_;
+    FrameArena        frames_;
+    TimingWheel       timers_;
+    AllocCounter      allocs_;
+    WorkerCounters    counters_;
+    std::array<bool, kMaxStrategies> moved_away_{}; // handed off from here, worker thread only
+    LatencyHistogram  dispatch_to_worker_;
+    LatencyHistogram  worker_to_return_;
+    std::thread       th_;
+};
+
+/*
+ * Each strategy is owned by exactly one worker, and every tick for that
+ * strategy goes to that worker. A given (instrument, strategy) stream therefore
+ * stays on one core in arrival order, and strategies never run concurrently
+ * with themselves.
+ *
+ * dispatch() and poll_handoffs() are called from the dispatcher thread only,
+ * which makes it the sole writer of the routing table and the sole producer of
+ * every worker queue. rebalance() may be called from any thread: it records a
+ * target, and the dispatcher carries out the move:
+ *   1. push a Handoff marker to the old owner and park new ticks locally,
+ *   2. once the old owner reaches the marker, switch the route and flush the
+ *      parked ticks to the new owner.
+ * Order is preserved and the strategy is never on two workers at once. At
+ * most kParkCapacity ticks are parked per strategy; one more makes the
+ * dispatcher wait for the old owner to reach the marker (park_stalls()).
+ */
+class ThreadPoolOfStrategies
+{
+  public:
+    explicit ThreadPoolOfStrategies(std::size_t n, const WorkerConfig& cfg = {})
+    {
+        moving_.reserve(kMaxStrategies);
+        workers_.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            workers_.push_back(std::make_unique<StrategyWorker>(strategies_, cfg, order_bell_));
+    }
+
+    // One worker per entry, e.g. spinning workers for latency-critical
+    // strategies next to parked ones for low-priority strategies.
+    explicit ThreadPoolOfStrategies(std::span<const WorkerConfig> per_worker)
+    {
+        moving_.reserve(kMaxStrategies);
+        workers_.reserve(per_worker.size());
+        for (const WorkerConfig& cfg : per_worker)
+            workers_.push_back(std::make_unique<StrategyWorker>(strategies_, cfg, order_bell_));
+    }
+
+    // Strategies may hold coroutine frames in their worker's FrameArena:
+    // stop the workers, then destroy the strategies, then the workers.
+    ~ThreadPoolOfStrategies()
+    {
+        for (auto& w : workers_) w->stop();
+        owned_.clear();
+    }
+
+    ThreadPoolOfStrategies(const ThreadPoolOfStrategies&)            = delete;
+    ThreadPoolOfStrategies& operator=(const ThreadPoolOfStrategies&) = delete;
+
+    // Cold path: call before ticks for the strategy start flowing.
+    void add_strategy(std::unique_ptr<Strategy> s, std::size_t worker)
+    {
+        const StrategyId sid = s->id();
+        assert(sid < kMaxStrategies && worker < workers_.size());
+        routes_[sid].owner = static_cast<std::uint32_t>(worker);
+        routes_[sid].parked.reserve(kParkCapacity); // a handoff parks without allocating
+        routes_[sid].target.store(routes_[sid].owner, std::memory_order_relaxed);
+        strategies_[sid].strategy.store(s.get(), std::memory_order_release);
+        owned_.push_back(std::move(s));
+    }
+
+    void rebalance(StrategyId sid, std::size_t worker)
+    {
+        assert(sid < kMaxStrategies && worker < workers_.size());
+        routes_[sid].target.store(static_cast<std::uint32_t>(worker), std::memory_order_relaxed);
+    }
+
+    std::size_t size() const noexcept { return workers_.size(); }
+    const ThreadActivity& activity(std::size_t worker) const noexcept { return workers_[worker]->activity(); }
+    QueueStats            queue_stats(std::size_t worker) const noexcept { return workers_[worker]->queue_stats(); }
+    ConflatingMailbox::Stats mailbox_stats(std::size_t worker) const noexcept { return workers_[worker]->mailbox_stats(); }
+    const AllocCounter&   allocations(std::size_t worker) const noexcept { return workers_[worker]->allocations(); }
+    const WorkerCounters& counters(std::size_t worker) const noexcept { return workers_[worker]->counters(); }
+
+    // Order path: one outbox per worker, all ringing one gateway doorbell.
+    OrderOutbox& outbox(std::size_t worker) noexcept { return workers_[worker]->outbox(); }
+    Doorbell&    order_bell() noexcept { return order_bell_; }
+
+    // Merged over all workers.
+    LatencyHistogram::Snapshot dispatch_to_worker() const noexcept
+    {
+        LatencyHistogram::Snapshot s;
+        for (const auto& w : workers_) s += w->dispatch_to_worker().snapshot();
+        return s;
+    }
+    LatencyHistogram::Snapshot worker_to_return() const noexcept
+    {
+        LatencyHistogram::Snapshot s;
+        for (const auto& w : workers_) s += w->worker_to_return().snapshot();
+        return s;
+    }
+    bool handoff_pending() const noexcept { return !moving_.empty(); }
+    // Handoffs whose park buffer filled, so the dispatcher waited them out.
+    std::uint64_t park_stalls() const noexcept { return park_stalls_.value(); }
+
+    // Dispatcher thread: retry overflow held back by Spill / DropOldest queues.
+    void flush()
+    {
+        for (auto& w : workers_) w->flush();
+    }
+    bool has_held() const noexcept
+    {
+        return std::ranges::any_of(workers_, [](const auto& w) { return w->has_held(); });
+    }
+
+    bool dispatch(const MarketDataAction& a)
+    {
+        Route& r = routes_[a.strategy];
+        if (!r.moving && r.target.load(std::memory_order_relaxed) != r.owner)
+            begin_handoff(a.strategy);
+        if (r.moving)
+        {
+            if (r.parked.size() < kParkCapacity)
+            {
+                r.parked.push_back(a);
+                return true;
+            }
+            // Full: never grow on the hot path, wait for the old owner instead.
+            park_stalls_.add();
+            while (!strategies_[a.strategy].handed_off.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            finish_handoff(static_cast<std::size_t>(std::ranges::find(moving_, a.strategy) - moving_.begin()));
+        }
+        return workers_[r.owner]->enqueue(a);
+    }
+
+    void poll_handoffs()
+    {
+        for (std::size_t i = 0; i < moving_.size();)
+        {
+            if (strategies_[moving_[i]].handed_off.load(std::memory_order_acquire))
+                finish_handoff(i);
+            else
+                ++i;
+        }
+    }
+
+  private:
+    static constexpr std::size_t kParkCapacity = 1024;
+
+    struct Route
+    {
+        std::uint32_t                 owner{0};  // dispatcher-owned
+        std::uint32_t                 to{0};     // destination of an in-flight handoff
+        bool                          moving{false};
+        std::vector<MarketDataAction> parked;    // ticks held back during a handoff, at most kParkCapacity
+        std::atomic<std::uint32_t>    target{0}; // requested owner, written by rebalance()
+    };
+
+    // The old owner has reached the marker: switch the route and flush.
+    void finish_handoff(std::size_t i)
+    {
+        Route& r = routes_[moving_[i]];
+        r.owner  = r.to;
+        r.moving = false;
+        for (const auto& a : r.parked)
+            workers_[r.owner]->enqueue_blocking(a);
+        r.parked.clear();
+        moving_[i] = moving_.back();
+        moving_.pop_back();
+    }
+
+    void begin_handoff(StrategyId sid)
+    {
+        Route& r = routes_[sid];
+        r.to     = r.target.load(std::memory_order_relaxed);
+        r.moving = true;
+        strategies_[sid].handed_off.store(false, std::memory_order_relaxed);
+        const MarketDataAction marker{kInvalidId, sid, ActionKind::Handoff, {}};
+        workers_[r.owner]->enqueue_blocking(marker);
+        moving_.push_back(sid);
+    }
+
+    StrategyTable                             strategies_;
+    Doorbell                                  order_bell_{true};
+    std::array<Route, kMaxStrategies>         routes_;
+    std::vector<StrategyId>                   moving_;
+    Counter                                   park_stalls_; // dispatcher-owned
+    std::vector<std::unique_ptr<Strategy>>    owned_;
+    std::vector<std::unique_ptr<StrategyWorker>> workers_;
+};
+
+// ---------- 7. Dispatcher ---------------------------------------------------
+
+// Written by the dispatcher thread only; see Counter.
+struct alignas(kCacheLine) DispatcherCounters
+{
+    Counter ticks;  // drained from the feed lanes
+    Counter routed; // actions handed to the pool, one per (tick, subscribed strategy)
+    Counter bursts;
+};
+
+struct DispatcherConfig
+{
+    WaitConfig     wait{};
+    OverflowConfig overflow{};                 // applied to every feed's lane
+    TickRecorder*  recorder{nullptr};          // capture every accepted tick
+    int            cpu{-1};                    // pin target, see EnginePlacement
+    std::size_t    feeds{1};                   // ingestion threads that may connect()
+    std::chrono::milliseconds feed_timeout{0}; // count a stall when a feed is silent this long; 0 = off
+};
+
+/*
+ * Fan-in: every feed handler connect()s once and gets its own SPSC lane, so
+ * any number of ingestion threads feed one dispatcher without locks or shared
+ * producer-side cache lines. The dispatcher polls the lanes round-robin, at
+ * most kDrainBatch actions per lane per pass, and starts each pass one lane
+ * further on, so a busy feed cannot starve a quiet one. Order is preserved
+ * within a feed; ticks from different feeds interleave in polling order.
+ *
+ * With feed_timeout set, a periodic timer on the dispatcher's own wheel counts
+ * every interval in which a feed published nothing (feed_stalls()).
+ */
+class Dispatcher
+{
+    using Queue = EngineQueue<MarketDataAction, 1 << 16>; // 65536
+
+  public:
+    // One feed's lane. The connecting thread is its only producer.
+    class Input
+    {
+      public:
+        bool accept(const MarketDataAction& a)
+        {
+            if (!q_.offer(a)) return false;
+            bell_.ring();
+            return true;
+        }
+        // Lossless variant for replay: waits for room instead of applying the policy.
+        void accept_blocking(const MarketDataAction& a)
+        {
+            while (!q_.try_put(a))
+            {
+                bell_.ring();
+                cpu_relax();
+            }
+            bell_.ring();
+        }
+        void flush()
+        {
+            if (!q_.has_held()) return;
+            q_.flush();
+            bell_.ring();
+        }
+
+        QueueStats stats() const noexcept { return q_.stats(); }
+
+      private:
+        friend class Dispatcher;
+        Input(const OverflowConfig& cfg, Doorbell& bell): q_(cfg), bell_(bell) {}
+
+        Queue     q_;
+        Doorbell& bell_;
+        std::uint64_t              seen_{0};   // pushed at the last watchdog check, dispatcher-owned
+        std::atomic<std::uint64_t> stalls_{0};
+    };
+
+    Dispatcher(InstrumentStrategyRegistry& reg,
+               MarketDataStore&           store,
+               ThreadPoolOfStrategies&    pool,
+               const DispatcherConfig&    cfg = {})
+        : registry_(reg), reader_(reg.register_reader()), store_(store), pool_(pool),
+          wait_(cfg.wait), cpu_(cfg.cpu), bell_(cfg.wait.policy == WaitPolicy::SpinPark), recorder_(cfg.recorder),
+          feed_timeout_(cfg.feed_timeout), inputs_(make_inputs(cfg, bell_)), th_([this]{ run(); })
+    {
+        ready_.wait(false, std::memory_order_acquire);
+    }
+
+    ~Dispatcher()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        bell_.wake();
+        if (th_.joinable()) th_.join();
+    }
+
+    // Cold path, once per ingestion thread. Throws when all cfg.feeds lanes are taken.
+    Input& connect()
+    {
+        const std::size_t i = connected_.fetch_add(1, std::memory_order_relaxed);
+        if (i >= inputs_.size()) throw std::runtime_error("Dispatcher: more feeds than DispatcherConfig::feeds");
+        return *inputs_[i];
+    }
+
+    const ThreadActivity& activity() const noexcept { return activity_; }
+    const AllocCounter&   allocations() const noexcept { return allocs_; }
+    const DispatcherCounters& counters() const noexcept { return counters_; }
+    std::size_t           feeds() const noexcept { return inputs_.size(); }
+    QueueStats            queue_stats(std::size_t feed = 0) const noexcept { return inputs_[feed]->stats(); }
+    // Watchdog intervals in which the feed published nothing; see DispatcherConfig::feed_timeout.
+    std::uint64_t feed_stalls(std::size_t feed = 0) const noexcept
+    {
+        return inputs_[feed]->stalls_.load(std::memory_order_relaxed);
+    }
+
+    // ingestion -> dispatcher: MarketData::ts to the start of the dispatcher's burst
+    const LatencyHistogram& ingest_to_dispatch() const noexcept { return ingest_to_dispatch_; }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    static std::vector<std::unique_ptr<Input>> make_inputs(const DispatcherConfig& cfg, Doorbell& bell)
+    {
+        std::vector<std::unique_ptr<Input>> inputs;
+        inputs.reserve(std::max<std::size_t>(cfg.feeds, 1));
+        for (std::size_t i = 0; i < std::max<std::size_t>(cfg.feeds, 1); ++i)
+            inputs.push_back(std::unique_ptr<Input>(new Input(cfg.overflow, bell)));
+        return inputs;
+    }
+
+    static void check_feeds(void* self, TimerId, std::uint64_t)
+    {
+        for (auto& in : static_cast<Dispatcher*>(self)->inputs_)
+        {
+            const std::uint64_t pushed = in->q_.stats().pushed;
+            if (pushed == in->seen_)
+                in->stalls_.store(in->stalls_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            in->seen_ = pushed;
+        }
+    }
+
+    void run()
+    {
+        pin_current_thread(cpu_);
+        for (auto& in : inputs_) in->q_.prefault(); // see StrategyWorker::run()
+        TimingWheel::current() = &timers_;
+        if (feed_timeout_.count() > 0) timers_.schedule_every(feed_timeout_, &Dispatcher::check_feeds, this);
+        ready_.store(true, std::memory_order_release);
+        ready_.notify_one();
+
+        std::array<MarketDataAction, kDrainBatch> batch;
+        IdleStrategy idle(wait_, bell_);
+        std::size_t  first = 0; // lane that goes first in the next pass
+        const NoAllocScope no_alloc(allocs_);
+        while (running_.load(std::memory_order_relaxed))
+        {
+            // One fair pass: each lane drains at most one burst, starting one
+            // lane further on each time. The epoch pin covers the pass only, so
+            // subscription changes land on the next one and retired snapshots
+            // can be reclaimed under continuous traffic.
+            bool found = false;
+            {
+                const auto subscriptions = registry_.read(reader_);
+                for (std::size_t k = 0; k < inputs_.size(); ++k)
+                {
+                    Input& in = *inputs_[(first + k) % inputs_.size()];
+                    const std::size_t n = in.q_.pop_n(batch);
+                    if (n == 0) continue;
+                    found = true;
+                    activity_.mark_busy();
+                    idle.reset();
+                    counters_.bursts.add();
+                    counters_.ticks.add(n);
+                    const Clock::time_point now = Clock::now(); // one clock read per burst
+                    for (MarketDataAction& a : std::span(batch).first(n))
+                    {
+                        ingest_to_dispatch_.record(now - a.data.ts);
+                        a.dispatched = now;
+                        if (recorder_) recorder_->record(a);
+                        store_.update(a.instrument, a.data);
+
+                        const auto subscribers = subscriptions.lookup(a.instrument);
+                        for (const StrategyId sid : subscribers)
+                        {
+                            a.strategy = sid;
+                            pool_.dispatch(a);
+                        }
+                        counters_.routed.add(subscribers.size());
+                    }
+                }
+            }
+            first = (first + 1) % inputs_.size();
+            // After every pass, busy or not: handoffs, held overflow and the
+            // feed watchdog must not wait for the lanes to go quiet.
+            pool_.poll_handoffs();
+            pool_.flush();
+            if (timers_.size()) timers_.advance(Clock::now());
+            if (found) continue;
+
+            activity_.mark_idle();
+            // Never park while a handoff or a held-back overflow still needs flushing.
+            idle.idle(
+                [this] {
+                    return std::ranges::any_of(inputs_, [](const auto& in) { return !in->q_.empty(); }) ||
+                           pool_.handoff_pending() || pool_.has_held() || !running_.load(std::memory_order_relaxed);
+                },
+                timers_.size() ? std::max(timers_.next_check() - Clock::now(), Clock::duration::zero())
+                               : Clock::duration::max());
+        }
+    }
+
+    InstrumentStrategyRegistry& registry_;
+    const std::size_t           reader_;
+    MarketDataStore&            store_;
+    ThreadPoolOfStrategies&     pool_;
+    const WaitConfig            wait_;
+    const int                   cpu_;
+    Doorbell                    bell_;
+    ThreadActivity              activity_;
+    LatencyHistogram            ingest_to_dispatch_;
+    TickRecorder*               recorder_;
+    AllocCounter                allocs_;
+    DispatcherCounters          counters_;
+    const std::chrono::milliseconds feed_timeout_;
+    TimingWheel                 timers_{64, std::chrono::milliseconds(1)};
+    const std::vector<std::unique_ptr<Input>> inputs_;
+    std::atomic<std::size_t>    connected_{0};
+    std::atomic<bool>           running_{true};
+    std::atomic<bool>           ready_{false};
+    std::thread                 th_;
+};
+
+// ---------- 8. Market data ingestion ---------------------------------------
+
+// Ticks between processes: a feed handler process publishes, the engine
+// process consumes with ShmIngestion. See ShmRing.
+using MarketDataShmRing = ShmRing<MarketDataAction, 1 << 14>; // 16384
+
+// Written by the ingestion thread only; see Counter.
+struct alignas(kCacheLine) IngestionCounters
+{
+    Counter published; // accepted by the dispatcher lane (or the shm ring)
+    Counter dropped;   // refused because that was full
+};
+
+class MarketDataIngestion
+{
+  public:
+    // Instruments that have a book in books also get mock depth, written by
+    // this thread (the book's single writer).
+    explicit MarketDataIngestion(Dispatcher& d, int cpu = -1, OrderBookStore* books = nullptr)
+        : input_(&d.connect()), cpu_(cpu), books_(books), th_([this]{ run(); })
+    {}
+    // Publishes into a shared-memory ring instead, for an engine in another
+    // process. ring must be a Producer handle; ticks that find it full are
+    // dropped and counted.
+    explicit MarketDataIngestion(MarketDataShmRing& ring, int cpu = -1)
+        : shm_(&ring), cpu_(cpu), books_(nullptr), th_([this]{ run(); })
+    {}
+    ~MarketDataIngestion()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        if (th_.joinable()) th_.join();
+    }
+
+    // Called from main thread to subscribe while the feed runs; mock impl.
+    // The slot is filled first and then published by the count.
+    void subscribe(InstrumentId inst)
+    {
+        const std::size_t n = n_subs_.load(std::memory_order_relaxed);
+        if (n == kMaxSubs) throw std::runtime_error("MarketDataIngestion: too many subscriptions");
+        subs_[n] = inst;
+        last_[n] = 0.0;
+        n_subs_.store(n + 1, std::memory_order_release);
+    }
+
+    const ThreadActivity&    activity() const noexcept { return activity_; }
+    const IngestionCounters& counters() const noexcept { return counters_; }
+    std::uint64_t            dropped() const noexcept { return counters_.dropped.value(); }
+
+  private:
+    void publish(const MarketDataAction& a)
+    {
+        if (input_ ? input_->accept(a) : shm_->push(a))
+            counters_.published.add();
+        else
+            counters_.dropped.add();
+    }
+
+    void run()
+    {
+        pin_current_thread(cpu_);
+        // Mock: publish random prices every 1 ms
+        while (running_.load(std::memory_order_relaxed))
+        {
+            activity_.mark_busy();
+            if (input_) input_->flush();
+            const std::size_t n = n_subs_.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                MarketData md{random_price(), 1.0,
+                              std::chrono::steady_clock::now()};
+                if (OrderBook* book = books_ ? books_->find(subs_[i]) : nullptr)
+                    quote_book(*book, last_[i], md.price);
+                last_[i] = md.price;
+                publish({.instrument = subs_[i], .data = md});
+            }
+            activity_.mark_idle();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Mock depth: five levels a tick apart either side of the last trade.
+    static void quote_book(OrderBook& book, double prev, double price)
+    {
+        const double tick = book.tick_size();
+        for (int l = 1; prev > 0 && l <= 5; ++l)
+        {
+            book.remove(Side::Buy, prev - l * tick);
+            book.remove(Side::Sell, prev + l * tick);
+        }
+        for (int l = 1; l <= 5; ++l)
+        {
+            book.modify(Side::Buy, price - l * tick, 100.0 * l);
+            book.modify(Side::Sell, price + l * tick, 100.0 * l);
+        }
+    }
+
+    static double random_price()
+    {
+        static thread_local uint32_t s = 1234567u;
+        s = s * 1664525u + 1013904223u;
+        return 100.0 + (s % 1000) / 10.0; // 100 – 200
+    }
+
+    static constexpr std::size_t kMaxSubs = 64;
+
+    Dispatcher::Input*                   input_{nullptr}; // one of input_ / shm_
+    MarketDataShmRing*                   shm_{nullptr};
+    const int                            cpu_;
+    OrderBookStore*                      books_;
+    std::array<InstrumentId, kMaxSubs>   subs_{};
+    std::array<double, kMaxSubs>         last_{}; // last mock price per subscription
+    std::atomic<std::size_t>             n_subs_{0};
+    IngestionCounters                    counters_;
+    ThreadActivity                       activity_;
+    std::atomic<bool>                    running_{true};
+    std::thread                          th_;
+};
+
+/*
+ * The engine-process end of a MarketDataShmRing: drains ticks published by a
+ * feed handler in another process into this process's dispatcher lane, in
+ * bursts of kDrainBatch. Ticks keep their publisher's stamp, so
+ * ingest_to_dispatch() includes the hop between processes. The lane's
+ * overflow policy applies as for an in-process feed.
+ */
+class ShmIngestion
+{
+  public:
+    // ring must be a Consumer handle.
+    ShmIngestion(Dispatcher& d, MarketDataShmRing& ring, WaitConfig wait = {}, int cpu = -1)
+        : input_(d.connect()), ring_(ring), wait_(wait), cpu_(cpu), th_([this] { run(); })
+    {}
+    ~ShmIngestion()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        if (th_.joinable()) th_.join();
+    }
+
+    std::uint64_t            received() const noexcept { return received_.load(std::memory_order_relaxed); }
+    // The publishing process is attached and running.
+    bool                     feed_alive() const noexcept { return ring_.peer_alive(); }
+    const ThreadActivity&    activity() const noexcept { return activity_; }
+    const IngestionCounters& counters() const noexcept { return counters_; }
+
+  private:
+    void run()
+    {
+        pin_current_thread(cpu_);
+        std::array<MarketDataAction, kDrainBatch> batch;
+        // Nobody rings a doorbell across the process boundary, so this thread
+        // polls: a SpinPark policy spins and yields but never parks.
+        Doorbell     never_rung;
+        IdleStrategy idle({wait_.policy == WaitPolicy::SpinPark ? WaitPolicy::SpinYield : wait_.policy,
+                           wait_.spin_limit, wait_.yield_limit},
+                          never_rung);
+        while (running_.load(std::memory_order_relaxed))
+        {
+            input_.flush();
+            if (const std::size_t n = ring_.pop_n(batch))
+            {
+                activity_.mark_busy();
+                idle.reset();
+                for (const MarketDataAction& a : std::span(batch).first(n))
+                    (input_.accept(a) ? counters_.published : counters_.dropped).add();
+                received_.store(received_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+                continue;
+            }
+            activity_.mark_idle();
+            idle.idle([] { return false; });
+        }
+    }
+
+    Dispatcher::Input&         input_;
+    MarketDataShmRing&         ring_;
+    const WaitConfig           wait_;
+    const int                  cpu_;
+    ThreadActivity             activity_;
+    IngestionCounters          counters_;
+    std::atomic<std::uint64_t> received_{0};
+    std::atomic<bool>          running_{true};
+    std::thread                th_;
+};
+
+/*
+ * Replays a TickFile into the dispatcher, either as fast as the pipeline
+ * accepts (speed <= 0) or on the captured timeline scaled by speed (2.0 = twice
+ * as fast). Captured instrument names are re-interned, so a capture replays
+ * correctly against a process that assigned different ids. Ticks are
+ * re-stamped at publish time so latency histograms measure this run, and are
+ * never dropped: the replay waits for room instead.
+ */
+class ReplayIngestion
+{
+    using Clock = std::chrono::steady_clock;
+
+  public:
+    ReplayIngestion(Dispatcher& d, const TickFile& file, SymbolTable& instruments, double speed = 0.0, int cpu = -1)
+        : input_(d.connect()), file_(file), speed_(speed), cpu_(cpu)
+    {
+        // Captured ids index ids_ and, once mapped, every per-instrument table
+        // in the engine, so a corrupt one rejects the file here. With a symbol
+        // table ids must name a symbol; without one (unfinished capture) they
+        // must still fit the engine.
+        const std::uint32_t named = file.header().symbol_count;
+        const std::uint64_t limit = named ? named : kMaxInstruments;
+        if (named > kMaxInstruments)
+            throw std::runtime_error("ReplayIngestion: capture names " + std::to_string(named) +
+                                     " instruments, more than kMaxInstruments");
+        std::uint32_t used = std::max<std::uint32_t>(named, 1);
+        for (const TickRecord& r : file.records())
+        {
+            if (r.instrument >= limit)
+                throw std::runtime_error("ReplayIngestion: record " + std::to_string(&r - file.records().data()) +
+                                         " has instrument id " + std::to_string(r.instrument) + ", beyond " +
+                                         std::to_string(limit));
+            used = std::max(used, r.instrument + 1);
+        }
+        ids_.resize(used);
+        for (InstrumentId i = 0; i < used; ++i)
+            if ((ids_[i] = instruments.intern(file.symbol(i))) >= kMaxInstruments)
+                throw std::runtime_error("ReplayIngestion: no room for instrument " + file.symbol(i));
+        th_ = std::thread([this] { run(); });
+    }
+
+    ~ReplayIngestion()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        if (th_.joinable()) th_.join();
+    }
+
+    bool                     done() const noexcept { return done_.load(std::memory_order_acquire); }
+    std::uint64_t            replayed() const noexcept { return counters_.published.value(); }
+    const ThreadActivity&    activity() const noexcept { return activity_; }
+    const IngestionCounters& counters() const noexcept { return counters_; } // never drops
+
+  private:
+    void run()
+    {
+        pin_current_thread(cpu_);
+        const std::span<const TickRecord> records = file_.records();
+        const Clock::time_point           start   = Clock::now();
+        const std::int64_t                first   = records.empty() ? 0 : records.front().ts_ns;
+
+        activity_.mark_busy();
+        for (const TickRecord& r : records)
+        {
+            if (!running_.load(std::memory_order_relaxed)) break;
+            if (speed_ > 0.0) pace(start + std::chrono::nanoseconds(static_cast<std::int64_t>((r.ts_ns - first) / speed_)));
+
+            input_.accept_blocking(
+                {.instrument = ids_[r.instrument], .data = MarketData{r.price, r.size, Clock::now()}});
+            counters_.published.add();
+        }
+        activity_.mark_idle();
+        done_.store(true, std::memory_order_release);
+    }
+
+    // Sleep through long gaps, spin the last stretch for timing accuracy.
+    void pace(Clock::time_point due)
+    {
+        constexpr auto kSpinWindow = std::chrono::microseconds(50);
+        for (Clock::time_point now = Clock::now(); now < due; now = Clock::now())
+        {
+            if (due - now > kSpinWindow)
+            {
+                activity_.mark_idle();
+                std::this_thread::sleep_for(due - now - kSpinWindow);
+                activity_.mark_busy();
+            }
+            else
+                cpu_relax();
+        }
+    }
+
+    Dispatcher::Input&         input_;
+    const TickFile&            file_;
+    const double               speed_;
+    const int                  cpu_;
+    std::vector<InstrumentId>  ids_; // captured id -> id in this process
+    ThreadActivity             activity_;
+    IngestionCounters          counters_;
+    std::atomic<bool>          done_{false};
+    std::atomic<bool>          running_{true};
+    std::thread                th_;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+// ---------- Thread placement: CPU topology, pinning, first touch ----------
+
+struct CpuInfo
+{
+    int cpu;
+    int package; // socket
+    int core;    // core id within the package; SMT siblings share (package, core)
+    int node;    // NUMA node
+};
+
+// CPUs this process may run on, as described by /sys. On a box without sysfs
+// topology every CPU becomes its own core on node 0.
+class CpuTopology
+{
+  public:
+    static CpuTopology detect()
+    {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+            for (unsigned i = 0; i < std::thread::hardware_concurrency(); ++i) CPU_SET(i, &allowed);
+
+        CpuTopology t;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (!CPU_ISSET(cpu, &allowed)) continue;
+            const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+            t.cpus_.push_back({cpu, read_int(base + "/topology/physical_package_id", 0),
+                               read_int(base + "/topology/core_id", cpu), node_of(base)});
+        }
+        return t;
+    }
+
+    const std::vector<CpuInfo>& cpus() const noexcept { return cpus_; }
+
+  private:
+    static int read_int(const std::string& path, int fallback)
+    {
+        std::ifstream in(path);
+        int           v;
+        return in >> v ? v : fallback;
+    }
+
+    // The cpuN directory holds a nodeM link for its NUMA node.
+    static int node_of(const std::string& cpu_dir)
+    {
+        std::error_code ec;
+        for (const auto& e : std::filesystem::directory_iterator(cpu_dir, ec))
+        {
+            const std::string name = e.path().filename().string();
+            if (name.size() > 4 && name.starts_with("node") &&
+                std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+                return std::stoi(name.substr(4));
+        }
+        return 0;
+    }
+
+    std::vector<CpuInfo> cpus_;
+};
+
+// Pins the calling thread; cpu < 0 leaves it unpinned.
+inline bool pin_current_thread(int cpu)
+{
+    if (cpu < 0) return true;
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    if (::pthread_setaffinity_np(::pthread_self(), sizeof(cpuset), &cpuset))
+    {
+        std::cerr << "Failed to pin thread to cpu " << cpu << "\n";
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Which CPU each engine thread runs on; -1 = unpinned.
+ *
+ * plan() keeps the whole pipeline on the NUMA node with the most physical
+ * cores, so every ring buffer hand-off stays within one memory controller:
+ *  * the dispatcher gets a physical core to itself;
+ *  * the first ingestion thread, its producer, goes on the dispatcher's SMT
+ *    sibling if there is one (the ring lines then never leave that core's
+ *    L1/L2); further feeds take the next physical cores;
+ *  * workers take the remaining physical cores, then the remaining siblings;
+ *  * the node's first core is left to the OS and main() when there are spare
+ *    cores.
+ * Threads that do not fit on the node stay unpinned rather than being spread
+ * across sockets.
+ *
+ * Each consumer also first-touches its ring on its own thread (see prefault()),
+ * so Linux allocates the ring's pages on the consumer's node.
+ */
+struct EnginePlacement
+{
+    int              node{-1};
+    int              dispatcher{-1};
+    std::vector<int> ingestion; // one per feed
+    std::vector<int> workers;
+
+    static EnginePlacement plan(const CpuTopology& topo, std::size_t n_workers, std::size_t n_feeds = 1)
+    {
+        EnginePlacement p;
+        p.ingestion.assign(n_feeds, -1);
+        p.workers.assign(n_workers, -1);
+
+        // node -> (package, core) -> cpus, all in ascending order
+        std::map<int, std::map<std::pair<int, int>, std::vector<int>>> nodes;
+        for (const CpuInfo& c : topo.cpus()) nodes[c.node][{c.package, c.core}].push_back(c.cpu);
+        if (nodes.empty()) return p;
+
+        const auto best = std::max_element(nodes.begin(), nodes.end(),
+                                           [](const auto& a, const auto& b) { return a.second.size() < b.second.size(); });
+        p.node = best->first;
+
+        std::vector<std::vector<int>> cores;
+        for (auto& [id, cpus] : best->second) cores.push_back(std::move(cpus));
+        if (cores.size() > n_workers + n_feeds + 1) cores.erase(cores.begin()); // housekeeping core
+
+        std::vector<int> primaries, siblings;
+        for (const auto& cpus : cores)
+        {
+            primaries.push_back(cpus.front());
+            siblings.insert(siblings.end(), cpus.begin() + 1, cpus.end());
+        }
+
+        std::size_t next = 0;
+        p.dispatcher     = primaries[next++];
+        for (std::size_t f = 0; f < n_feeds; ++f)
+        {
+            if (f == 0 && cores.front().size() > 1)
+            {
+                p.ingestion[f] = cores.front()[1];
+                siblings.erase(std::find(siblings.begin(), siblings.end(), p.ingestion[f]));
+            }
+            else if (next < primaries.size())
+                p.ingestion[f] = primaries[next++];
+        }
+
+        std::vector<int> rest(primaries.begin() + static_cast<std::ptrdiff_t>(next), primaries.end());
+        rest.insert(rest.end(), siblings.begin(), siblings.end());
+        for (std::size_t i = 0; i < n_workers && i < rest.size(); ++i) p.workers[i] = rest[i];
+        return p;
+    }
+};
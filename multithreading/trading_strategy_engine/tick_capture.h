@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "engine_types.h"
+#include "spsc_ring_buffer.h"
+
+// ---------- Binary tick capture / replay -----------------------------------
+
+/*
+ * File layout (little-endian, native structs):
+ *
+ *   TickFileHeader
+ *   TickRecord[record_count]          fixed 32-byte records, capture order
+ *   TickSymbol[symbol_count]          at symbols_offset; index = captured id
+ *
+ * The header is rewritten on close. A capture cut short by a crash still has
+ * record_count == 0 and no symbols; the reader then derives the count from the
+ * file size and names instruments by their captured ids.
+ */
+struct TickFileHeader
+{
+    static constexpr std::array<char, 8> kMagic{'T', 'I', 'C', 'K', 'C', 'A', 'P', '1'};
+    static constexpr std::uint32_t       kVersion = 1;
+
+    std::array<char, 8> magic{kMagic};
+    std::uint32_t       version{kVersion};
+    std::uint32_t       record_size{};
+    std::uint64_t       record_count{};
+    std::uint64_t       symbols_offset{};
+    std::uint32_t       symbol_count{};
+    std::uint32_t       reserved{};
+};
+
+struct TickRecord
+{
+    std::int64_t ts_ns;      // steady_clock at ingestion
+    InstrumentId instrument; // id in the capturing process, see TickSymbol
+    std::uint32_t reserved;
+    double       price;
+    double       size;
+};
+
+struct TickSymbol
+{
+    std::array<char, 16> name; // NUL-padded
+};
+
+static_assert(sizeof(TickFileHeader) == 40 && sizeof(TickRecord) == 32 && sizeof(TickSymbol) == 16);
+static_assert(std::is_trivially_copyable_v<TickRecord>);
+
+/*
+ * Captures ticks off the hot path: record() is one SPSC push from the
+ * dispatcher thread; a background thread drains the ring and does the file
+ * I/O. If the writer cannot keep up the tick is counted in dropped() rather
+ * than stalling the dispatcher.
+ */
+class TickRecorder
+{
+    using Ring = SpscRingBuffer<TickRecord, 1 << 16>;
+
+  public:
+    TickRecorder(const std::string& path, const SymbolTable& instruments)
+        : file_(std::fopen(path.c_str(), "wb")), instruments_(instruments)
+    {
+        if (!file_) throw std::system_error(errno, std::generic_category(), "TickRecorder: cannot open " + path);
+        // A valid header with record_count 0: if we never get to finish(),
+        // TickFile derives the count from the file size.
+        TickFileHeader placeholder;
+        placeholder.record_size = sizeof(TickRecord);
+        if (std::fwrite(&placeholder, sizeof(placeholder), 1, file_) != 1 || std::fflush(file_) != 0)
+        {
+            const int err = errno;
+            std::fclose(file_);
+            throw std::system_error(err, std::generic_category(), "TickRecorder: cannot write " + path);
+        }
+        th_ = std::thread([this] { run(); });
+    }
+
+    ~TickRecorder()
+    {
+        running_.store(false, std::memory_order_release);
+        if (th_.joinable()) th_.join();
+        finish();
+    }
+
+    TickRecorder(const TickRecorder&)            = delete;
+    TickRecorder& operator=(const TickRecorder&) = delete;
+
+    // Producer side (dispatcher thread).
+    void record(const MarketDataAction& a) noexcept
+    {
+        const TickRecord r{a.data.ts.time_since_epoch().count(), a.instrument, 0, a.data.price, a.data.size};
+        if (!ring_.push(r)) dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t written() const noexcept { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const noexcept
+    {
+        return dropped_.load(std::memory_order_relaxed) + lost_.load(std::memory_order_relaxed);
+    }
+    // A write failed (e.g. disk full); every tick from then on is dropped.
+    bool          failed() const noexcept { return failed_.load(std::memory_order_relaxed); }
+
+  private:
+    void run()
+    {
+        std::array<TickRecord, 1024> batch;
+        for (;;)
+        {
+            const bool        stopping = !running_.load(std::memory_order_acquire);
+            const std::size_t n        = ring_.pop_n(batch);
+            if (n)
+            {
+                // Only whole records count; a torn tail is overwritten by finish().
+                const std::size_t done = failed() ? 0 : std::fwrite(batch.data(), sizeof(TickRecord), n, file_);
+                written_.store(written_.load(std::memory_order_relaxed) + done, std::memory_order_relaxed);
+                if (done < n)
+                {
+                    failed_.store(true, std::memory_order_relaxed);
+                    lost_.store(lost_.load(std::memory_order_relaxed) + (n - done), std::memory_order_relaxed);
+                }
+            }
+            else if (stopping)
+                return;
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    // The header only ever claims what is on disk. If the symbols or the
+    // header cannot be written, the file is cut back to the whole records and
+    // left with the placeholder, which readers handle as an unfinished capture.
+    void finish()
+    {
+        TickFileHeader h;
+        h.record_size    = sizeof(TickRecord);
+        h.record_count   = written();
+        h.symbols_offset = sizeof(TickFileHeader) + h.record_count * sizeof(TickRecord);
+        h.symbol_count   = static_cast<std::uint32_t>(instruments_.size());
+        bool ok = std::fflush(file_) == 0 && std::fseek(file_, static_cast<long>(h.symbols_offset), SEEK_SET) == 0;
+        for (std::uint32_t id = 0; ok && id < h.symbol_count; ++id)
+        {
+            TickSymbol       sym{};
+            const std::string& name = instruments_.name(id);
+            std::memcpy(sym.name.data(), name.data(), std::min(name.size(), sym.name.size() - 1));
+            ok = std::fwrite(&sym, sizeof(sym), 1, file_) == 1;
+        }
+        ok = ok && std::fflush(file_) == 0 && std::fseek(file_, 0, SEEK_SET) == 0 &&
+             std::fwrite(&h, sizeof(h), 1, file_) == 1 && std::fflush(file_) == 0;
+        if (!ok)
+        {
+            failed_.store(true, std::memory_order_relaxed);
+            std::fflush(file_);
+            if (::ftruncate(::fileno(file_), static_cast<off_t>(h.symbols_offset)) == 0)
+            {
+                // Drop the record count again; it is derived from the size.
+                TickFileHeader placeholder;
+                placeholder.record_size = sizeof(TickRecord);
+                if (std::fseek(file_, 0, SEEK_SET) == 0) std::fwrite(&placeholder, sizeof(placeholder), 1, file_);
+            }
+        }
+        std::fclose(file_);
+    }
+
+    std::FILE*                 file_;
+    const SymbolTable&         instruments_;
+    Ring                       ring_;
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> dropped_{0}; // ring full, producer-owned
+    std::atomic<std::uint64_t> lost_{0};    // write failed, writer-owned
+    std::atomic<bool>          failed_{false};
+    std::atomic<bool>          running_{true};
+    std::thread                th_;
+};
+
+// Read-only mmap of a capture. Records are used in place, no parse step.
+class TickFile
+{
+  public:
+    explicit TickFile(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "TickFile: cannot open " + path);
+        struct stat st{};
+        ::fstat(fd, &st);
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ < sizeof(TickFileHeader))
+        {
+            ::close(fd);
+            throw std::runtime_error("TickFile: " + path + " is too short");
+        }
+        base_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base_ == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "TickFile: mmap " + path);
+        ::madvise(base_, size_, MADV_SEQUENTIAL);
+
+        if (header().magic != TickFileHeader::kMagic || header().version != TickFileHeader::kVersion ||
+            header().record_size != sizeof(TickRecord))
+        {
+            ::munmap(base_, size_);
+            throw std::runtime_error("TickFile: " + path + " is not a v1 tick capture");
+        }
+        // Everything the header claims must lie inside the file, so records()
+        // and symbol() never read past the mapping.
+        const TickFileHeader& h         = header();
+        const std::size_t     body      = size_ - sizeof(TickFileHeader);
+        const bool            unfinished = h.record_count == 0 && h.symbol_count == 0;
+        count_ = unfinished ? body / sizeof(TickRecord) : h.record_count;
+        if (count_ > body / sizeof(TickRecord) ||
+            (h.symbol_count && (h.symbols_offset < sizeof(TickFileHeader) + count_ * sizeof(TickRecord) ||
+                                h.symbols_offset > size_ ||
+                                h.symbol_count > (size_ - h.symbols_offset) / sizeof(TickSymbol))))
+        {
+            ::munmap(base_, size_);
+            throw std::runtime_error("TickFile: " + path + " is truncated or corrupt");
+        }
+    }
+
+    ~TickFile() { ::munmap(base_, size_); }
+
+    TickFile(const TickFile&)            = delete;
+    TickFile& operator=(const TickFile&) = delete;
+
+    const TickFileHeader& header() const noexcept { return *static_cast<const TickFileHeader*>(base_); }
+
+    // An unfinished capture (no record count, no symbols) holds as many whole
+    // records as the file has room for.
+    std::span<const TickRecord> records() const noexcept
+    {
+        return {reinterpret_cast<const TickRecord*>(static_cast<const char*>(base_) + sizeof(TickFileHeader)), count_};
+    }
+
+    // Name of a captured instrument id; "#<id>" if the capture has no symbol table.
+    std::string symbol(InstrumentId captured) const
+    {
+        if (captured >= header().symbol_count) return "#" + std::to_string(captured);
+        const auto* syms = reinterpret_cast<const TickSymbol*>(static_cast<const char*>(base_) + header().symbols_offset);
+        return std::string(syms[captured].name.data(), ::strnlen(syms[captured].name.data(), syms[captured].name.size()));
+    }
+
+  private:
+    void*       base_{nullptr};
+    std::size_t size_{0};
+    std::size_t count_{0}; // records
+};
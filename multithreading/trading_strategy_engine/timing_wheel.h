@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+// ---------- Hierarchical timing wheel ---------------------------------------
+
+// Generation in the high half, slot index + 1 in the low half; 0 = no timer.
+using TimerId = std::uint64_t;
+inline constexpr TimerId kNoTimer = 0;
+
+enum class TimerAlign : std::uint8_t
+{
+    None,      // first fire one period from now
+    WallClock, // first fire on the next multiple of the period on system_clock
+};
+
+/*
+ * Timers for one engine thread, advanced from its own loop between queue
+ * drains: no timer thread, no sleep_for.
+ *
+ * Four levels of 256 slots each. Level 0 slots are one resolution wide (1 us
+ * by default), level 1 slots 256 resolutions, and so on, so the wheel spans
+ * 2^32 resolutions (~71 min at 1 us); later deadlines wait in the last level
+ * and are re-filed as they come into range. A timer sits in an intrusive list
+ * in the slot its deadline falls into; it moves down a level each time the
+ * wheel reaches its slot (cascading) and fires from level 0.
+ *
+ *  * schedule / cancel: O(1), a list insert / unlink on preallocated nodes;
+ *  * advance(): jumps straight to the next occupied slot using a 256-bit
+ *    occupancy map per level, so a loop that was idle for a while pays per
+ *    occupied slot, not per elapsed resolution.
+ *
+ * Periodic timers are re-armed from their original phase (deadline + period),
+ * so they do not drift with loop latency; when the loop falls behind by whole
+ * periods, the missed ones are skipped rather than fired in a burst.
+ * Callbacks may schedule and cancel timers, including their own.
+ */
+class TimingWheel
+{
+  public:
+    using Clock    = std::chrono::steady_clock;
+    using Callback = void (*)(void* ctx, TimerId id, std::uint64_t cookie);
+
+    static constexpr unsigned    kLevels   = 4;
+    static constexpr unsigned    kSlotBits = 8;
+    static constexpr std::size_t kSlots    = std::size_t{1} << kSlotBits;
+
+    explicit TimingWheel(std::size_t capacity = 4096, Clock::duration resolution = std::chrono::microseconds(1),
+                         Clock::time_point start = Clock::now())
+        : resolution_(resolution), origin_(start), nodes_(std::make_unique<Node[]>(capacity)), capacity_(capacity)
+    {
+        assert(capacity > 0 && capacity < std::numeric_limits<std::uint32_t>::max() && resolution.count() > 0);
+        for (std::size_t i = 0; i < capacity; ++i) nodes_[i].next = i + 1 < capacity ? &nodes_[i + 1] : nullptr;
+        free_ = &nodes_[0];
+    }
+
+    TimingWheel(const TimingWheel&)            = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    // The wheel of the calling engine thread; nullptr elsewhere.
+    static TimingWheel*& current() noexcept
+    {
+        thread_local TimingWheel* wheel = nullptr;
+        return wheel;
+    }
+
+    // kNoTimer when all capacity timers are in use. A deadline that has
+    // already passed fires on the next advance() that moves the wheel.
+    TimerId schedule_at(Clock::time_point deadline, Callback fn, void* ctx, std::uint64_t cookie = 0) noexcept
+    {
+        return arm(std::max(ticks_ceil(deadline), now_ + 1), 0, fn, ctx, cookie);
+    }
+    // Relative deadlines count from the later of now() and steady_clock: the
+    // engine loops only advance a wheel that has timers, so an idle wheel's
+    // own time is stale.
+    TimerId schedule_after(Clock::duration delay, Callback fn, void* ctx, std::uint64_t cookie = 0) noexcept
+    {
+        return schedule_at(base() + delay, fn, ctx, cookie);
+    }
+    // Period is rounded to whole resolutions (at least one).
+    TimerId schedule_every(Clock::duration period, Callback fn, void* ctx, std::uint64_t cookie = 0,
+                           TimerAlign align = TimerAlign::None) noexcept
+    {
+        const std::uint64_t p     = std::max<std::uint64_t>(static_cast<std::uint64_t>(period / resolution_), 1);
+        Clock::time_point   first = base() + period;
+        if (align == TimerAlign::WallClock)
+        {
+            // Same conversion as LoopEverySecondAlignedToWallClock: next wall
+            // multiple of the period, mapped onto steady_clock once.
+            const auto sys  = std::chrono::system_clock::now().time_since_epoch();
+            const auto wall = (sys / period + 1) * period;
+            first           = Clock::now() + std::chrono::duration_cast<Clock::duration>(wall - sys);
+        }
+        return arm(std::max(ticks_ceil(first), now_ + 1), p, fn, ctx, cookie);
+    }
+
+    // False if id already fired (one-shot), was cancelled, or is kNoTimer.
+    // Safe from inside any callback, including the timer's own.
+    bool cancel(TimerId id) noexcept
+    {
+        Node* n = find(id);
+        if (!n) return false;
+        if (n->level == kFiring)
+            n->period = 0; // released once its callback returns
+        else
+        {
+            unlink(n);
+            release(n);
+        }
+        return true;
+    }
+
+    // Fires every timer due at or before now, in deadline order; returns the
+    // number fired.
+    std::size_t advance(Clock::time_point now) noexcept
+    {
+        const std::uint64_t target = ticks_floor(now);
+        std::size_t         fired  = 0;
+        while (now_ < target)
+        {
+            const std::uint64_t next = next_event();
+            if (next > target)
+            {
+                now_ = target;
+                break;
+            }
+            now_ = next;
+            cascade();
+            fired += expire(static_cast<std::size_t>(now_ & kMask), target);
+        }
+        return fired;
+    }
+
+    // Earliest time advance() may have work: the next level-0 deadline, or the
+    // next cascade, which can only be earlier than the real deadline.
+    // Clock::time_point::max() when no timer is armed.
+    Clock::time_point next_check() const noexcept
+    {
+        if (armed_ == 0) return Clock::time_point::max();
+        return origin_ + resolution_ * static_cast<Clock::rep>(next_event());
+    }
+
+    Clock::time_point now() const noexcept { return origin_ + resolution_ * static_cast<Clock::rep>(now_); }
+    std::size_t       size() const noexcept { return armed_; }
+    std::size_t       capacity() const noexcept { return capacity_; }
+
+  private:
+    static constexpr std::uint64_t kMask    = kSlots - 1;
+    static constexpr std::uint8_t  kFiring  = 0xFE; // Node::level while its callback runs
+    static constexpr std::uint8_t  kUnarmed = 0xFF;
+
+    struct Node
+    {
+        Node*         prev{nullptr};
+        Node*         next{nullptr}; // also the free list
+        std::uint64_t expires{0};    // in resolutions since origin_
+        std::uint64_t period{0};     // 0 = one-shot
+        Callback      fn{nullptr};
+        void*         ctx{nullptr};
+        std::uint64_t cookie{0};
+        std::uint32_t gen{0};
+        std::uint8_t  level{kUnarmed};
+        std::uint8_t  slot{0};
+    };
+
+    struct Level
+    {
+        std::array<Node*, kSlots>         head{};
+        std::array<std::uint64_t, kSlots / 64> bits{};
+        std::size_t                       count{0};
+
+        void mark(std::size_t s) noexcept { bits[s / 64] |= std::uint64_t{1} << (s % 64); }
+        void clear(std::size_t s) noexcept { bits[s / 64] &= ~(std::uint64_t{1} << (s % 64)); }
+
+        // First occupied slot >= from, or kSlots.
+        std::size_t next_from(std::size_t from) const noexcept
+        {
+            for (std::size_t w = from / 64; w < bits.size(); ++w)
+            {
+                std::uint64_t word = bits[w];
+                if (w == from / 64) word &= ~std::uint64_t{0} << (from % 64);
+                if (word) return w * 64 + static_cast<std::size_t>(std::countr_zero(word));
+            }
+            return kSlots;
+        }
+    };
+
+    static constexpr unsigned shift(unsigned level) noexcept { return level * kSlotBits; }
+
+    Clock::time_point base() const noexcept { return std::max(now(), Clock::now()); }
+
+    std::uint64_t ticks_floor(Clock::time_point t) const noexcept
+    {
+        return t <= origin_ ? 0 : static_cast<std::uint64_t>((t - origin_) / resolution_);
+    }
+    std::uint64_t ticks_ceil(Clock::time_point t) const noexcept
+    {
+        if (t <= origin_) return 0;
+        const Clock::duration d = t - origin_;
+        return static_cast<std::uint64_t>((d + resolution_ - Clock::duration(1)) / resolution_);
+    }
+
+    TimerId arm(std::uint64_t expires, std::uint64_t period, Callback fn, void* ctx, std::uint64_t cookie) noexcept
+    {
+        Node* n = free_;
+        if (!n) return kNoTimer;
+        free_     = n->next;
+        n->expires = expires;
+        n->period  = period;
+        n->fn      = fn;
+        n->ctx     = ctx;
+        n->cookie  = cookie;
+        insert(n);
+        ++armed_;
+        return id_of(n);
+    }
+
+    void release(Node* n) noexcept
+    {
+        ++n->gen; // stale ids stop matching
+        n->level = kUnarmed;
+        n->next  = free_;
+        free_    = n;
+        --armed_;
+    }
+
+    TimerId id_of(const Node* n) const noexcept
+    {
+        return (std::uint64_t{n->gen} << 32) | static_cast<std::uint64_t>(n - nodes_.get() + 1);
+    }
+
+    Node* find(TimerId id) const noexcept
+    {
+        const std::uint64_t index = id & 0xFFFF'FFFF;
+        if (index == 0 || index > capacity_) return nullptr;
+        Node* n = &nodes_[index - 1];
+        return n->level != kUnarmed && n->gen == static_cast<std::uint32_t>(id >> 32) ? n : nullptr;
+    }
+
+    // Files n by how far its deadline is from now_; expires >= now_.
+    void insert(Node* n) noexcept
+    {
+        const std::uint64_t delta = n->expires - now_;
+        unsigned            level = 0;
+        while (level + 1 < kLevels && delta >= (std::uint64_t{1} << shift(level + 1))) ++level;
+        // Beyond the top level's span: park in its furthest slot, re-filed on cascade.
+        const std::uint64_t span = std::uint64_t{1} << shift(kLevels);
+        const std::uint64_t at   = delta < span ? n->expires : now_ + span - 1;
+        const std::size_t   s    = static_cast<std::size_t>((at >> shift(level)) & kMask);
+
+        Level& l  = levels_[level];
+        n->level  = static_cast<std::uint8_t>(level);
+        n->slot   = static_cast<std::uint8_t>(s);
+        n->prev   = nullptr;
+        n->next   = l.head[s];
+        if (n->next) n->next->prev = n;
+        l.head[s] = n;
+        l.mark(s);
+        ++l.count;
+    }
+
+    void unlink(Node* n) noexcept
+    {
+        Level& l = levels_[n->level];
+        if (n->prev)
+            n->prev->next = n->next;
+        else
+            l.head[n->slot] = n->next;
+        if (n->next) n->next->prev = n->prev;
+        if (!l.head[n->slot]) l.clear(n->slot);
+        --l.count;
+    }
+
+    // Next tick after now_ at which a level-0 slot fires or a higher-level
+    // slot cascades; max() when nothing is armed.
+    std::uint64_t next_event() const noexcept
+    {
+        std::uint64_t best = std::numeric_limits<std::uint64_t>::max();
+        for (unsigned level = 0; level < kLevels; ++level)
+        {
+            const Level& l = levels_[level];
+            if (l.count == 0) continue;
+            const unsigned      sh     = shift(level);
+            const std::uint64_t window = std::uint64_t{1} << (sh + kSlotBits);
+            const std::uint64_t base   = now_ & ~(window - 1);
+            // Slot starts after now_: the rest of this window, then the next one.
+            // The current slot itself is empty at level 0 and, at higher levels,
+            // can only hold deadlines a full window away.
+            const std::size_t cur = static_cast<std::size_t>((now_ >> sh) & kMask);
+            std::size_t       s   = l.next_from(cur + 1 < kSlots ? cur + 1 : kSlots);
+            std::uint64_t     at;
+            if (s < kSlots)
+                at = base + (std::uint64_t{s} << sh);
+            else
+            {
+                s  = l.next_from(0);
+                at = base + window + (std::uint64_t{s} << sh);
+            }
+            best = std::min(best, at);
+        }
+        return best;
+    }
+
+    // At now_, re-file every higher-level slot that starts here.
+    void cascade() noexcept
+    {
+        for (unsigned level = 1; level < kLevels; ++level)
+        {
+            if (now_ & ((std::uint64_t{1} << shift(level)) - 1)) break;
+            Level&            l = levels_[level];
+            const std::size_t s = static_cast<std::size_t>((now_ >> shift(level)) & kMask);
+            Node*             n = l.head[s];
+            l.head[s]           = nullptr;
+            l.clear(s);
+            while (n)
+            {
+                Node* next = n->next;
+                --l.count;
+                insert(n);
+                n = next;
+            }
+        }
+    }
+
+    // target: where the current advance() ends. A periodic timer is re-armed
+    // past it, so one that fell behind fires once, not once per missed period.
+    std::size_t expire(std::size_t s, std::uint64_t target) noexcept
+    {
+        std::size_t fired = 0;
+        Level&      l     = levels_[0];
+        while (Node* n = l.head[s])
+        {
+            unlink(n);
+            n->level = kFiring;
+            ++fired;
+            n->fn(n->ctx, id_of(n), n->cookie);
+            if (n->period == 0)
+            {
+                release(n);
+                continue;
+            }
+            // Same phase as before; skip periods the loop has already missed.
+            n->expires += n->period;
+            if (n->expires <= target) n->expires += ((target - n->expires) / n->period + 1) * n->period;
+            insert(n);
+        }
+        return fired;
+    }
+
+    const Clock::duration        resolution_;
+    const Clock::time_point      origin_;
+    std::uint64_t                now_{0}; // resolutions since origin_, all due timers up to here have fired
+    std::array<Level, kLevels>   levels_{};
+    std::unique_ptr<Node[]>      nodes_;
+    const std::size_t            capacity_;
+    Node*                        free_{nullptr};
+    std::size_t                  armed_{0};
+};
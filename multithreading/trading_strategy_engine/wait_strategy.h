@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "platform.h"
+
+// ---------- Idle / wait policies for engine threads ------------------------
+
+enum class WaitPolicy : std::uint8_t
+{
+    BusySpin,  // pause forever: lowest latency, burns the core
+    SpinYield, // pause, then sched_yield: core is shared but never released
+    SpinPark,  // pause, yield, then sleep on a futex until a producer rings
+};
+
+struct WaitConfig
+{
+    WaitPolicy    policy{WaitPolicy::SpinYield};
+    std::uint32_t spin_limit{256}; // empty polls spent on pause before yielding
+    std::uint32_t yield_limit{64}; // SpinPark: empty polls spent yielding before parking
+};
+
+/*
+ * Futex-backed wake-up for a parked consumer.
+ *
+ * The consumer announces it is about to sleep, re-checks its queue and only
+ * then waits; the producer publishes, then looks for a sleeper. Both sides put
+ * a seq_cst fence between their store and their load, so either the consumer
+ * sees the new element or the producer sees the sleeper. The producer pays for
+ * the fence only when the consumer can park at all.
+ *
+ * park() takes an optional timeout so a thread with timers armed sleeps only
+ * until the next one is due. std::atomic::wait has no timeout, so on Linux
+ * both sides use the futex directly; elsewhere a timed park returns at once
+ * and the caller keeps polling.
+ */
+class Doorbell
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Doorbell(bool parkable = false) noexcept: parkable_(parkable) {}
+
+    // Producer side, after publishing.
+    void ring() noexcept
+    {
+        if (!parkable_) return;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed)) wake();
+    }
+
+    // Unconditional wake, e.g. for shutdown.
+    void wake() noexcept
+    {
+        gen_.fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+        futex(FUTEX_WAKE_PRIVATE, 1, nullptr);
+#else
+        gen_.notify_one();
+#endif
+    }
+
+    // Consumer side. Returns after a wake-up or once timeout has passed.
+    template <typename HasWork>
+    void park(HasWork&& has_work, Clock::duration timeout = Clock::duration::max()) noexcept
+    {
+        const std::uint32_t gen = gen_.load(std::memory_order_acquire);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!has_work() && timeout > Clock::duration::zero()) wait(gen, timeout);
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+  private:
+    void wait(std::uint32_t gen, Clock::duration timeout) noexcept
+    {
+#if defined(__linux__)
+        if (timeout == Clock::duration::max())
+        {
+            futex(FUTEX_WAIT_PRIVATE, gen, nullptr);
+            return;
+        }
+        const auto     ns = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+        const timespec ts{static_cast<time_t>(ns / 1'000'000'000), static_cast<long>(ns % 1'000'000'000)};
+        futex(FUTEX_WAIT_PRIVATE, gen, &ts);
+#else
+        if (timeout == Clock::duration::max()) gen_.wait(gen, std::memory_order_acquire);
+#endif
+    }
+
+#if defined(__linux__)
+    // Spurious returns (EINTR, EAGAIN) are fine: the caller re-polls.
+    void futex(int op, std::uint32_t val, const timespec* timeout) noexcept
+    {
+        static_assert(sizeof(gen_) == sizeof(std::uint32_t));
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&gen_), op, val, timeout, nullptr, 0);
+    }
+#endif
+
+    const bool                 parkable_;
+    std::atomic<bool>          sleeping_{false};
+    std::atomic<std::uint32_t> gen_{0};
+};
+
+// Busy / idle wall time of one engine thread. Written by its owner only,
+// under a seqlock; any thread may read it. The interval in progress counts
+// towards the current state, so a thread parked for a second reads as idle.
+class ThreadActivity
+{
+    using Clock = std::chrono::steady_clock;
+
+  public:
+    // Owner side. Cheap when the state does not change: the clock is read on
+    // transitions only.
+    void mark_busy() noexcept { transition(true); }
+    void mark_idle() noexcept { transition(false); }
+
+    std::chrono::nanoseconds busy() const noexcept { return std::chrono::nanoseconds(read().busy); }
+    std::chrono::nanoseconds idle() const noexcept { return std::chrono::nanoseconds(read().idle); }
+
+  private:
+    struct Totals
+    {
+        std::int64_t busy;
+        std::int64_t idle;
+    };
+
+    void transition(bool busy) noexcept
+    {
+        if (busy == busy_.load(std::memory_order_relaxed) && since_ns_.load(std::memory_order_relaxed)) return;
+        const std::int64_t  now   = Clock::now().time_since_epoch().count();
+        const std::int64_t  since = since_ns_.load(std::memory_order_relaxed);
+        const std::uint64_t s     = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        if (since)
+        {
+            auto& counter = busy_.load(std::memory_order_relaxed) ? busy_ns_ : idle_ns_;
+            counter.store(counter.load(std::memory_order_relaxed) + (now - since), std::memory_order_relaxed);
+        }
+        busy_.store(busy, std::memory_order_relaxed);
+        since_ns_.store(now, std::memory_order_relaxed);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    Totals read() const noexcept
+    {
+        for (;;)
+        {
+            const std::uint64_t before = seq_.load(std::memory_order_acquire);
+            Totals              t{busy_ns_.load(std::memory_order_relaxed), idle_ns_.load(std::memory_order_relaxed)};
+            const bool          busy  = busy_.load(std::memory_order_relaxed);
+            const std::int64_t  since = since_ns_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (before & 1 || seq_.load(std::memory_order_relaxed) != before) continue;
+            if (since)
+            {
+                const std::int64_t open = Clock::now().time_since_epoch().count() - since;
+                (busy ? t.busy : t.idle) += std::max<std::int64_t>(open, 0);
+            }
+            return t;
+        }
+    }
+
+    std::atomic<std::uint64_t> seq_{0}; // odd = transition in progress
+    std::atomic<std::int64_t>  busy_ns_{0};
+    std::atomic<std::int64_t>  idle_ns_{0};
+    std::atomic<bool>          busy_{false};
+    std::atomic<std::int64_t>  since_ns_{0}; // start of the current state, 0 = never marked
+};
+
+// Per-thread back-off state machine driven by the owner's poll loop.
+class IdleStrategy
+{
+  public:
+    IdleStrategy(WaitConfig cfg, Doorbell& bell) noexcept: cfg_(cfg), bell_(bell) {}
+
+    // Poll found work.
+    void reset() noexcept { empty_polls_ = 0; }
+
+    // Poll found nothing; has_work is re-checked before parking, and a park
+    // lasts at most max_sleep (the owner's next timer).
+    template <typename HasWork>
+    void idle(HasWork&& has_work, Doorbell::Clock::duration max_sleep = Doorbell::Clock::duration::max()) noexcept
+    {
+        const std::uint32_t n = empty_polls_++;
+        if (cfg_.policy == WaitPolicy::BusySpin || n < cfg_.spin_limit)
+            cpu_relax();
+        else if (cfg_.policy == WaitPolicy::SpinYield || n < cfg_.spin_limit + cfg_.yield_limit)
+            std::this_thread::yield();
+        else
+        {
+            bell_.park(has_work, max_sleep);
+            empty_polls_ = 0;
+        }
+    }
+
+  private:
+    WaitConfig    cfg_;
+    Doorbell&     bell_;
+    std::uint32_t empty_polls_{0};
+};
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "alloc_guard.h"
+#include "arena.h"
+#include "engine_types.h"
+#include "latency_histogram.h"
+#include "platform.h"
+#include "spsc_ring_buffer.h"
+#include "strategy.h"
+#include "strategy_engine.h"
+#include "thread_placement.h"
+#include "wait_strategy.h"
+
+// ---------- Work-stealing executor with instrument lanes -------------------
+
+/*
+ * Fixed-capacity Chase-Lev deque (Lê et al., "Correct and Efficient
+ * Work-Stealing for Weak Memory Models", 2013). The owner pushes and pops at
+ * the bottom with no RMW except when racing a thief for the last element;
+ * thieves take from the top with one CAS. Never grows: callers size it so a
+ * push cannot fail.
+ */
+template <typename T, std::size_t CapacityPow2>
+class ChaseLevDeque
+{
+    static_assert(CapacityPow2 > 0 && (CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be power of two");
+    static_assert(std::is_trivially_copyable_v<T> && std::atomic<T>::is_always_lock_free);
+
+  public:
+    // ---- owner ----
+
+    bool push(T v) noexcept
+    {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= static_cast<std::int64_t>(CapacityPow2)) return false;
+        buffer_[b & kMask].store(v, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release); // publishes the slot to thieves
+        return true;
+    }
+
+    bool pop(T& out) noexcept
+    {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            bottom_.store(b + 1, std::memory_order_relaxed); // empty
+            return false;
+        }
+        out = buffer_[b & kMask].load(std::memory_order_relaxed);
+        if (t < b) return true;
+        // Last element: whoever moves top_ first gets it.
+        const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    // ---- any other thread ----
+
+    // False when empty or when another thief / the owner won the race.
+    bool steal(T& out) noexcept
+    {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return false;
+        out = buffer_[t & kMask].load(std::memory_order_relaxed);
+        return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // Approximate while others are running.
+    bool empty() const noexcept
+    {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    static constexpr std::int64_t kMask = CapacityPow2 - 1;
+
+    alignas(kCacheLine) std::atomic<std::int64_t> top_{0};    // thieves
+    alignas(kCacheLine) std::atomic<std::int64_t> bottom_{0}; // owner
+    alignas(kCacheLine) std::array<std::atomic<T>, CapacityPow2> buffer_{};
+};
+
+/*
+ * Alternative to ThreadPoolOfStrategies for skewed workloads, where pinning a
+ * strategy to one worker lets an expensive strategy back up its worker while
+ * the others idle.
+ *
+ * Work is organised in lanes, one per instrument. Every strategy belongs to
+ * exactly one lane and sees all of that lane's ticks. submit() appends a tick
+ * to the lane's SPSC ring and, if the lane is not already scheduled, hands its
+ * id to the lane's home worker. Workers keep scheduled lanes in a Chase-Lev
+ * deque; a worker with nothing to do steals a lane from another worker's
+ * deque. Running a lane drains up to kDrainBatch ticks and calls each of its
+ * strategies once with the whole batch, then re-queues the lane if it still
+ * has ticks.
+ *
+ * The scheduled flag means a lane is in at most one deque or on one worker at
+ * a time. Its ticks are therefore consumed in order, by one thread at a time,
+ * and its strategies never run concurrently with themselves. Each lane id sits
+ * in at most one place, so deques and hand-off rings sized for kMaxInstruments
+ * cannot overflow.
+ *
+ * Strategies that need ticks from several instruments stay on the static pool.
+ * Of WorkerConfig only wait, cpu and scratch_bytes apply. Idle workers only
+ * steal while awake; with SpinPark a parked worker wakes for its own lanes only.
+ * The executor has no order path yet: send_order() returns 0 (no order) here.
+ */
+class WorkStealingExecutor
+{
+    using Clock    = std::chrono::steady_clock;
+    using LaneRing = SpscRingBuffer<MarketDataAction, 1 << 10>;
+
+    struct Lane
+    {
+        alignas(kCacheLine) std::atomic<bool> scheduled{false};
+        std::uint32_t          home{0};
+        std::vector<Strategy*> strategies; // fixed once ticks flow
+        LaneRing               ticks;
+    };
+
+    class Worker
+    {
+      public:
+        Worker(WorkStealingExecutor& ex, std::size_t index, const WorkerConfig& cfg)
+            : ex_(ex), index_(index), wait_(cfg.wait), cpu_(cfg.cpu), bell_(cfg.wait.policy == WaitPolicy::SpinPark),
+              scratch_(cfg.scratch_bytes)
+        {}
+
+        ~Worker() { stop(); }
+
+        void start()
+        {
+            th_ = std::thread([this] { run(); });
+            ready_.wait(false, std::memory_order_acquire);
+        }
+        void stop()
+        {
+            running_.store(false, std::memory_order_relaxed);
+            bell_.wake();
+            if (th_.joinable()) th_.join();
+        }
+
+        // Producer side: lane became runnable and this is its home.
+        void schedule(std::uint32_t lane) noexcept
+        {
+            [[maybe_unused]] const bool ok = inbox_.push(lane);
+            assert(ok);
+            bell_.ring();
+        }
+
+        bool steal(std::uint32_t& lane) noexcept { return deque_.steal(lane); }
+
+        const ThreadActivity&   activity() const noexcept { return activity_; }
+        const AllocCounter&     allocations() const noexcept { return allocs_; }
+        const LatencyHistogram& dispatch_to_worker() const noexcept { return dispatch_to_worker_; }
+        const LatencyHistogram& worker_to_return() const noexcept { return worker_to_return_; }
+        std::uint64_t           batches() const noexcept { return batches_.load(std::memory_order_relaxed); }
+        std::uint64_t           stolen() const noexcept { return stolen_.load(std::memory_order_relaxed); }
+
+      private:
+        static void bump(std::atomic<std::uint64_t>& c) noexcept
+        {
+            c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        // Own lanes first (newly scheduled ones on top), then another worker's.
+        bool next_lane(std::uint32_t& lane) noexcept
+        {
+            std::array<std::uint32_t, kDrainBatch> fresh;
+            const std::size_t n = inbox_.pop_n(fresh);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                [[maybe_unused]] const bool ok = deque_.push(fresh[i]);
+                assert(ok);
+            }
+            if (deque_.pop(lane)) return true;
+            const std::size_t workers = ex_.workers_.size();
+            for (std::size_t k = 1; k < workers; ++k)
+                if (ex_.workers_[(index_ + k) % workers]->steal(lane))
+                {
+                    bump(stolen_);
+                    return true;
+                }
+            return false;
+        }
+
+        void run_lane(std::uint32_t id)
+        {
+            Lane&             lane = *ex_.lanes_[id];
+            const std::size_t n    = lane.ticks.pop_n(batch_);
+            if (n)
+            {
+                const Clock::time_point received = Clock::now();
+                const auto              burst    = std::span<const MarketDataAction>(batch_).first(n);
+                for (const MarketDataAction& a : burst) dispatch_to_worker_.record(received - a.dispatched);
+                for (Strategy* s : lane.strategies) s->on_market_data(burst);
+                worker_to_return_.record(Clock::now() - received, n);
+                scratch_.reset();
+                bump(batches_);
+            }
+            if (!lane.ticks.empty())
+            {
+                deque_.push(id); // still runnable, stays scheduled
+                return;
+            }
+            // Release the lane, then look again: a tick pushed before the
+            // producer saw scheduled == true must not be stranded. Pairs with
+            // the fence in submit().
+            lane.scheduled.store(false, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!lane.ticks.empty() && !lane.scheduled.exchange(true, std::memory_order_acq_rel)) deque_.push(id);
+        }
+
+        void run()
+        {
+            pin_current_thread(cpu_);
+            inbox_.prefault();
+            scratch_.prefault();
+            Arena::current() = &scratch_;
+            ready_.store(true, std::memory_order_release);
+            ready_.notify_one();
+
+            IdleStrategy       idle(wait_, bell_);
+            const NoAllocScope no_alloc(allocs_);
+            while (running_.load(std::memory_order_relaxed))
+            {
+                std::uint32_t lane;
+                if (next_lane(lane))
+                {
+                    activity_.mark_busy();
+                    idle.reset();
+                    run_lane(lane);
+                    continue;
+                }
+                activity_.mark_idle();
+                idle.idle([this] {
+                    return !inbox_.empty() || !deque_.empty() || !running_.load(std::memory_order_relaxed);
+                });
+            }
+        }
+
+        WorkStealingExecutor& ex_;
+        const std::size_t     index_;
+        const WaitConfig      wait_;
+        const int             cpu_;
+        Doorbell              bell_;
+        ThreadActivity        activity_;
+        std::atomic<bool>     running_{true};
+        std::atomic<bool>     ready_{false};
+        SpscRingBuffer<std::uint32_t, kMaxInstruments> inbox_; // submit() -> home worker
+        ChaseLevDeque<std::uint32_t, kMaxInstruments>  deque_;
+        std::array<MarketDataAction, kDrainBatch>      batch_;
+        Arena                      scratch_;
+        AllocCounter               allocs_;
+        LatencyHistogram           dispatch_to_worker_;
+        LatencyHistogram           worker_to_return_;
+        std::atomic<std::uint64_t> batches_{0};
+        std::atomic<std::uint64_t> stolen_{0};
+        std::thread                th_;
+    };
+
+  public:
+    explicit WorkStealingExecutor(std::size_t n, const WorkerConfig& cfg = {})
+        : WorkStealingExecutor(std::vector<WorkerConfig>(n, cfg))
+    {}
+
+    explicit WorkStealingExecutor(std::span<const WorkerConfig> per_worker)
+        : lanes_(std::make_unique<std::unique_ptr<Lane>[]>(kMaxInstruments))
+    {
+        assert(!per_worker.empty());
+        workers_.reserve(per_worker.size());
+        for (std::size_t i = 0; i < per_worker.size(); ++i)
+            workers_.push_back(std::make_unique<Worker>(*this, i, per_worker[i]));
+        // Thieves look at every deque, so all workers exist before any runs.
+        for (auto& w : workers_) w->start();
+    }
+
+    ~WorkStealingExecutor()
+    {
+        for (auto& w : workers_) w->stop();
+    }
+
+    WorkStealingExecutor(const WorkStealingExecutor&)            = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    // Cold path, before ticks for inst start flowing. The first strategy on an
+    // instrument creates its lane; lanes are spread over workers round-robin.
+    void add_strategy(std::unique_ptr<Strategy> s, InstrumentId inst)
+    {
+        assert(inst < kMaxInstruments);
+        std::unique_ptr<Lane>& lane = lanes_[inst];
+        if (!lane)
+        {
+            lane       = std::make_unique<Lane>();
+            lane->home = static_cast<std::uint32_t>(lane_count_++ % workers_.size());
+        }
+        lane->strategies.push_back(s.get());
+        owned_.push_back(std::move(s));
+    }
+
+    // Producer side, one thread. a.instrument picks the lane, a.strategy is
+    // ignored: every strategy of the lane gets the tick. False if the lane
+    // does not exist or its ring is full.
+    bool submit(MarketDataAction a) noexcept
+    {
+        Lane* lane = a.instrument < kMaxInstruments ? lanes_[a.instrument].get() : nullptr;
+        if (!lane) return false;
+        a.dispatched = Clock::now();
+        if (!lane->ticks.push(a)) return false;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!lane->scheduled.load(std::memory_order_relaxed) &&
+            !lane->scheduled.exchange(true, std::memory_order_acq_rel))
+            workers_[lane->home]->schedule(a.instrument);
+        return true;
+    }
+
+    std::size_t           size() const noexcept { return workers_.size(); }
+    const ThreadActivity& activity(std::size_t worker) const noexcept { return workers_[worker]->activity(); }
+    const AllocCounter&   allocations(std::size_t worker) const noexcept { return workers_[worker]->allocations(); }
+    // Lane batches run by a worker, and how many of those it stole.
+    std::uint64_t batches(std::size_t worker) const noexcept { return workers_[worker]->batches(); }
+    std::uint64_t stolen(std::size_t worker) const noexcept { return workers_[worker]->stolen(); }
+
+    // Merged over all workers.
+    LatencyHistogram::Snapshot dispatch_to_worker() const noexcept
+    {
+        LatencyHistogram::Snapshot s;
+        for (const auto& w : workers_) s += w->dispatch_to_worker().snapshot();
+        return s;
+    }
+    LatencyHistogram::Snapshot worker_to_return() const noexcept
+    {
+        LatencyHistogram::Snapshot s;
+        for (const auto& w : workers_) s += w->worker_to_return().snapshot();
+        return s;
+    }
+
+  private:
+    std::unique_ptr<std::unique_ptr<Lane>[]> lanes_; // by InstrumentId
+    std::size_t                              lane_count_{0};
+    std::vector<std::unique_ptr<Strategy>>   owned_;
+    std::vector<std::unique_ptr<Worker>>     workers_;
+};